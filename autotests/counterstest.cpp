@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationcounters.h"
+#include "../src/decorationsettings.h"
+#include "../src/decorationshadow.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QCoreApplication>
+#include <QHoverEvent>
+#include <QTest>
+
+using KDecoration2::DecorationCounters;
+
+class CountersTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDecoration();
+    void testShadow();
+};
+
+void CountersTest::testDecoration()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(200);
+    client->setHeight(100);
+
+    const DecorationCounters::Snapshot before = DecorationCounters::snapshot();
+    {
+        MockButton button(KDecoration2::DecorationButtonType::Custom, &deco);
+        QCOMPARE(DecorationCounters::snapshot().buttonsCreated, before.buttonsCreated + 1);
+        QCOMPARE(DecorationCounters::snapshot().buttonsDestroyed, before.buttonsDestroyed);
+    }
+    QCOMPARE(DecorationCounters::snapshot().buttonsDestroyed, before.buttonsDestroyed + 1);
+
+    QHoverEvent event(QEvent::HoverMove, QPointF(10, 10), QPointF(10, 10));
+    QCoreApplication::sendEvent(&deco, &event);
+    QCOMPARE(DecorationCounters::snapshot().eventsDispatched, before.eventsDispatched + 1);
+
+    const DecorationCounters::Snapshot unscaled = DecorationCounters::snapshot();
+    deco.update(QRect(0, 0, 10, 20));
+    DecorationCounters::Snapshot after = DecorationCounters::snapshot();
+    QCOMPARE(after.bridgeUpdates, unscaled.bridgeUpdates + 1);
+    QCOMPARE(after.pixelsDamaged, unscaled.pixelsDamaged + 200);
+
+    // damage of other scales is counted in device pixels
+    deco.setScales({1.0, 2.0});
+    const DecorationCounters::Snapshot scaled = DecorationCounters::snapshot();
+    deco.update(QRect(0, 0, 10, 20));
+    after = DecorationCounters::snapshot();
+    QCOMPARE(after.bridgeUpdates, scaled.bridgeUpdates + 2);
+    QCOMPARE(after.pixelsDamaged, scaled.pixelsDamaged + 200 + 800);
+
+    const QVariantMap map = DecorationCounters::toVariantMap(after);
+    QCOMPARE(map.value(QStringLiteral("bridgeUpdates")).toLongLong(), after.bridgeUpdates);
+    QCOMPARE(map.value(QStringLiteral("pixelsDamaged")).toLongLong(), after.pixelsDamaged);
+}
+
+void CountersTest::testShadow()
+{
+    const DecorationCounters::Snapshot before = DecorationCounters::snapshot();
+    {
+        KDecoration2::DecorationShadow shadow;
+        QCOMPARE(DecorationCounters::snapshot().shadowsAlive, before.shadowsAlive + 1);
+        QImage image(10, 10, QImage::Format_ARGB32_Premultiplied);
+        shadow.setShadow(image);
+        QCOMPARE(DecorationCounters::snapshot().shadowBytes, before.shadowBytes + 400);
+        shadow.setShadow(QImage(20, 10, QImage::Format_ARGB32_Premultiplied));
+        QCOMPARE(DecorationCounters::snapshot().shadowBytes, before.shadowBytes + 800);
+    }
+    QCOMPARE(DecorationCounters::snapshot().shadowsAlive, before.shadowsAlive);
+    QCOMPARE(DecorationCounters::snapshot().shadowBytes, before.shadowBytes);
+}
+
+QTEST_MAIN(CountersTest)
+#include "counterstest.moc"
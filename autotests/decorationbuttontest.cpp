@@ -4,18 +4,48 @@
  * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
  */
 #include "../src/decoratedclient.h"
+#include "../src/decorationbuttongroup.h"
+#include "../src/decorationcounters.h"
 #include "../src/decorationsettings.h"
 #include "mockbridge.h"
 #include "mockbutton.h"
 #include "mockclient.h"
 #include "mockdecoration.h"
 #include "mocksettings.h"
+#include <QPointer>
 #include <QSignalSpy>
 #include <QStyleHints>
 #include <QTest>
 
 Q_DECLARE_METATYPE(Qt::MouseButton)
 
+struct ReplayEvent {
+    QEvent::Type type;
+    Qt::MouseButton button;
+    ulong timestamp;
+};
+Q_DECLARE_METATYPE(QVector<ReplayEvent>)
+
+class HoverCountingButton : public MockButton
+{
+public:
+    using MockButton::MockButton;
+    int enterCount = 0;
+    int leaveCount = 0;
+
+protected:
+    void hoverEnterEvent(QHoverEvent *event) override
+    {
+        enterCount++;
+        MockButton::hoverEnterEvent(event);
+    }
+    void hoverLeaveEvent(QHoverEvent *event) override
+    {
+        leaveCount++;
+        MockButton::hoverLeaveEvent(event);
+    }
+};
+
 class DecorationButtonTest : public QObject
 {
     Q_OBJECT
@@ -32,6 +62,8 @@ private Q_SLOTS:
     void testHoverLeaveIgnore_data();
     void testHoverLeaveIgnore();
     void testHover();
+    void testHoverRemovesButton();
+    void testHoverDelivery();
     void testMouseMove_data();
     void testMouseMove();
     void testClose();
@@ -45,9 +77,16 @@ private Q_SLOTS:
     void testMenu();
     void testMenuDoubleClick();
     void testMenuPressAndHold();
+    void testMenuDoubleClickTimestamp();
+    void testDoubleClickReplay_data();
+    void testDoubleClickReplay();
+    void testDeferredActions();
     void testApplicationMenu();
     void testContains_data();
     void testContains();
+    void testDeferredButtonGroup();
+    void testDevicePixelRatio();
+    void testStateFlags();
 };
 
 void DecorationButtonTest::testButton()
@@ -441,6 +480,70 @@ void DecorationButtonTest::testHover()
     QCOMPARE(hoveredChangedSpy.last().first().toBool(), false);
 }
 
+void DecorationButtonTest::testHoverRemovesButton()
+{
+    MockBridge bridge;
+    MockDecoration mockDecoration(&bridge);
+    QPointer<MockButton> first = new MockButton(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    MockButton second(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    MockButton third(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    first->setGeometry(QRectF(0, 0, 10, 10));
+    second.setGeometry(QRectF(0, 0, 10, 10));
+    third.setGeometry(QRectF(0, 0, 10, 10));
+    QSignalSpy secondEnteredSpy(&second, &KDecoration2::DecorationButton::pointerEntered);
+    QVERIFY(secondEnteredSpy.isValid());
+    QSignalSpy thirdEnteredSpy(&third, &KDecoration2::DecorationButton::pointerEntered);
+    QVERIFY(thirdEnteredSpy.isValid());
+
+    // removing an already visited button while the event is dispatched must not skip the next one
+    connect(&second, &KDecoration2::DecorationButton::pointerEntered, this, [&first] {
+        delete first.data();
+    });
+    QHoverEvent enterEvent(QEvent::HoverEnter, QPointF(5, 5), QPointF(-1, -1));
+    QCoreApplication::sendEvent(&mockDecoration, &enterEvent);
+    QVERIFY(first.isNull());
+    QCOMPARE(secondEnteredSpy.count(), 1);
+    QCOMPARE(thirdEnteredSpy.count(), 1);
+    QCOMPARE(second.isHovered(), true);
+    QCOMPARE(third.isHovered(), true);
+
+    // the remaining buttons are still found through their updated model index
+    QHoverEvent leaveEvent(QEvent::HoverLeave, QPointF(20, 20), QPointF(5, 5));
+    QCoreApplication::sendEvent(&mockDecoration, &leaveEvent);
+    QCOMPARE(second.isHovered(), false);
+    QCOMPARE(third.isHovered(), false);
+}
+
+void DecorationButtonTest::testHoverDelivery()
+{
+    // every button gets the enter and leave events of the Decoration, no matter its state
+    MockBridge bridge;
+    MockDecoration mockDecoration(&bridge);
+    HoverCountingButton inside(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    inside.setGeometry(QRectF(0, 0, 10, 10));
+    HoverCountingButton outside(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    outside.setGeometry(QRectF(20, 0, 10, 10));
+    HoverCountingButton disabled(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    disabled.setGeometry(QRectF(0, 0, 10, 10));
+    disabled.setEnabled(false);
+
+    QHoverEvent enterEvent(QEvent::HoverEnter, QPointF(5, 5), QPointF(-1, -1));
+    QCoreApplication::sendEvent(&mockDecoration, &enterEvent);
+    QCOMPARE(inside.enterCount, 1);
+    QCOMPARE(outside.enterCount, 1);
+    QCOMPARE(disabled.enterCount, 1);
+    QCOMPARE(inside.isHovered(), true);
+    QCOMPARE(outside.isHovered(), false);
+    QCOMPARE(disabled.isHovered(), false);
+
+    QHoverEvent leaveEvent(QEvent::HoverLeave, QPointF(50, 50), QPointF(5, 5));
+    QCoreApplication::sendEvent(&mockDecoration, &leaveEvent);
+    QCOMPARE(inside.leaveCount, 1);
+    QCOMPARE(outside.leaveCount, 1);
+    QCOMPARE(disabled.leaveCount, 1);
+    QCOMPARE(inside.isHovered(), false);
+}
+
 void DecorationButtonTest::testMouseMove_data()
 {
     QTest::addColumn<bool>("enabled");
@@ -1275,6 +1378,179 @@ void DecorationButtonTest::testMenuPressAndHold()
     QCOMPARE(closeRequestedSpy.count(), 0);
 }
 
+void DecorationButtonTest::testMenuDoubleClickTimestamp()
+{
+    // double clicks are detected based on the timestamps of the events
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+    MockButton button(KDecoration2::DecorationButtonType::Menu, &mockDecoration);
+    button.setGeometry(QRect(0, 0, 10, 10));
+    MockSettings *settings = bridge.lastCreatedSettings();
+    QVERIFY(settings);
+    settings->setCloseOnDoubleClickOnMenu(true);
+    // button used a queued connection, so we need to run event loop
+    QCoreApplication::processEvents();
+
+    QSignalSpy doubleClickedSpy(&button, &KDecoration2::DecorationButton::doubleClicked);
+    QVERIFY(doubleClickedSpy.isValid());
+    const int interval = QGuiApplication::styleHints()->mouseDoubleClickInterval();
+
+    auto click = [&button](ulong pressTime, ulong releaseTime) {
+        QMouseEvent pressEvent(QEvent::MouseButtonPress, QPointF(5, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        pressEvent.setTimestamp(pressTime);
+        button.event(&pressEvent);
+        QMouseEvent releaseEvent(QEvent::MouseButtonRelease, QPointF(5, 5), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+        releaseEvent.setTimestamp(releaseTime);
+        button.event(&releaseEvent);
+    };
+
+    // second press too late
+    click(1000, 1050);
+    click(1051 + interval, 1100 + interval);
+    QCOMPARE(doubleClickedSpy.count(), 0);
+
+    // second press just in time, no matter how much real time passed
+    click(10000, 10050);
+    click(10050 + interval, 10100 + interval);
+    QCOMPARE(doubleClickedSpy.count(), 1);
+
+    // synthesized events without a timestamp are timed when they get delivered
+    click(0, 0);
+    click(0, 0);
+    QCOMPARE(doubleClickedSpy.count(), 2);
+
+    // an event timestamp is never compared against a delivery time
+    click(20000, 20050);
+    click(0, 0);
+    click(20100, 20150);
+    QCOMPARE(doubleClickedSpy.count(), 2);
+}
+
+void DecorationButtonTest::testDoubleClickReplay_data()
+{
+    QTest::addColumn<QVector<ReplayEvent>>("events");
+    QTest::addColumn<int>("expectedDoubleClicks");
+
+    const ulong interval = QGuiApplication::styleHints()->mouseDoubleClickInterval();
+    const auto press = [](ulong timestamp, Qt::MouseButton button = Qt::LeftButton) {
+        return ReplayEvent{QEvent::MouseButtonPress, button, timestamp};
+    };
+    const auto release = [](ulong timestamp, Qt::MouseButton button = Qt::LeftButton) {
+        return ReplayEvent{QEvent::MouseButtonRelease, button, timestamp};
+    };
+
+    QTest::newRow("single") << QVector<ReplayEvent>{press(100), release(150)} << 0;
+    QTest::newRow("double") << QVector<ReplayEvent>{press(100), release(150), press(150 + interval), release(200 + interval)} << 1;
+    QTest::newRow("slow") << QVector<ReplayEvent>{press(100), release(150), press(151 + interval), release(200 + interval)} << 0;
+    QTest::newRow("triple") << QVector<ReplayEvent>{press(100), release(110), press(120), release(130), press(140), release(150)} << 2;
+    QTest::newRow("two doubles") << QVector<ReplayEvent>{press(100),
+                                                         release(110),
+                                                         press(120),
+                                                         release(130),
+                                                         press(200 + interval),
+                                                         release(210 + interval),
+                                                         press(220 + interval),
+                                                         release(230 + interval)}
+                                 << 2;
+    QTest::newRow("right button") << QVector<ReplayEvent>{press(100, Qt::RightButton),
+                                                          release(110, Qt::RightButton),
+                                                          press(120, Qt::RightButton),
+                                                          release(130, Qt::RightButton)}
+                                  << 0;
+    QTest::newRow("right button in between") << QVector<ReplayEvent>{press(100),
+                                                                     release(110),
+                                                                     press(120, Qt::RightButton),
+                                                                     release(130, Qt::RightButton),
+                                                                     press(140),
+                                                                     release(150)}
+                                             << 1;
+    QTest::newRow("timestamps going backwards") << QVector<ReplayEvent>{press(1000), release(1010), press(500), release(510)} << 0;
+}
+
+void DecorationButtonTest::testDoubleClickReplay()
+{
+    // replays timestamped event streams, the outcome must not depend on when the events are delivered
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+    MockButton button(KDecoration2::DecorationButtonType::Menu, &mockDecoration);
+    button.setGeometry(QRect(0, 0, 10, 10));
+    MockSettings *settings = bridge.lastCreatedSettings();
+    QVERIFY(settings);
+    settings->setCloseOnDoubleClickOnMenu(true);
+    // button used a queued connection, so we need to run event loop
+    QCoreApplication::processEvents();
+
+    QSignalSpy doubleClickedSpy(&button, &KDecoration2::DecorationButton::doubleClicked);
+    QVERIFY(doubleClickedSpy.isValid());
+
+    QFETCH(QVector<ReplayEvent>, events);
+    Qt::MouseButtons buttons = Qt::NoButton;
+    for (const ReplayEvent &replayEvent : events) {
+        if (replayEvent.type == QEvent::MouseButtonPress) {
+            buttons |= replayEvent.button;
+        } else {
+            buttons &= ~replayEvent.button;
+        }
+        QMouseEvent event(replayEvent.type, QPointF(5, 5), replayEvent.button, buttons, Qt::NoModifier);
+        event.setTimestamp(replayEvent.timestamp);
+        event.setAccepted(false);
+        button.event(&event);
+        QVERIFY(event.isAccepted());
+    }
+    QTEST(doubleClickedSpy.count(), "expectedDoubleClicks");
+    QVERIFY(!button.isPressed());
+}
+
+void DecorationButtonTest::testDeferredActions()
+{
+    using namespace KDecoration2;
+    MockBridge bridge;
+    QPointer<MockDecoration> mockDecoration = new MockDecoration(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setCloseable(true);
+    client->setMinimizable(true);
+    MockButton *closeButton = new MockButton(DecorationButtonType::Close, mockDecoration.data(), mockDecoration.data());
+    closeButton->setGeometry(QRect(0, 0, 10, 10));
+    MockButton *minimizeButton = new MockButton(DecorationButtonType::Minimize, mockDecoration.data(), mockDecoration.data());
+    minimizeButton->setGeometry(QRect(10, 0, 10, 10));
+
+    QSignalSpy closeRequestedSpy(client, &MockClient::closeRequested);
+    QVERIFY(closeRequestedSpy.isValid());
+    QSignalSpy minimizeRequestedSpy(client, &MockClient::minimizeRequested);
+    QVERIFY(minimizeRequestedSpy.isValid());
+
+    auto click = [](DecorationButton *button) {
+        const QPointF pos = button->geometry().center();
+        QMouseEvent pressEvent(QEvent::MouseButtonPress, pos, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        button->event(&pressEvent);
+        QMouseEvent releaseEvent(QEvent::MouseButtonRelease, pos, Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+        button->event(&releaseEvent);
+    };
+
+    // nothing is performed while the events are dispatched
+    click(minimizeButton);
+    click(closeButton);
+    click(minimizeButton);
+    QCOMPARE(minimizeRequestedSpy.count(), 0);
+    QCOMPARE(closeRequestedSpy.count(), 0);
+
+    // but all of it in the next event loop pass
+    QCoreApplication::processEvents();
+    QCOMPARE(minimizeRequestedSpy.count(), 2);
+    QCOMPARE(closeRequestedSpy.count(), 1);
+
+    // pending actions get dropped together with the decoration
+    click(closeButton);
+    delete mockDecoration.data();
+    QVERIFY(!mockDecoration);
+    QCoreApplication::processEvents();
+    QCOMPARE(closeRequestedSpy.count(), 1);
+}
+
 void DecorationButtonTest::testApplicationMenu()
 {
     MockBridge bridge;
@@ -1361,5 +1637,169 @@ void DecorationButtonTest::testContains()
     QTEST(button.contains(pos), "contains");
 }
 
+void DecorationButtonTest::testDeferredButtonGroup()
+{
+    using namespace KDecoration2;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close, DecorationButtonType::Minimize});
+    settings->setDecorationButtonsRight({DecorationButtonType::Maximize});
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+
+    int created = 0;
+    auto creator = [&created](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+        created++;
+        auto button = new MockButton(type, decoration, parent);
+        button->setGeometry(QRectF(0, 0, 10, 10));
+        return button;
+    };
+    DecorationButtonGroup left(DecorationButtonGroup::Position::Left, &mockDecoration, creator, QSizeF(10, 10));
+    DecorationButtonGroup right(DecorationButtonGroup::Position::Right, &mockDecoration, creator, QSizeF(10, 10));
+    left.setSpacing(2);
+    QCOMPARE(created, 0);
+    QVERIFY(left.hasButton(DecorationButtonType::Close));
+    QVERIFY(!left.hasButton(DecorationButtonType::Menu));
+    // the layout is based on the assumed button size
+    QCOMPARE(left.geometry(), QRectF(0, 0, 22, 10));
+
+    // changing the settings only updates the types
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close});
+    QCOMPARE(created, 0);
+    QCOMPARE(left.geometry(), QRectF(0, 0, 10, 10));
+
+    // painting a group creates its buttons
+    right.paint(nullptr, QRect());
+    QCOMPARE(created, 1);
+
+    // the first pointer event reaching the decoration creates all remaining buttons
+    QHoverEvent event(QEvent::HoverMove, QPointF(50, 50), QPointF(50, 50));
+    QCoreApplication::sendEvent(&mockDecoration, &event);
+    QCOMPARE(created, 2);
+    QCOMPARE(left.buttons().count(), 1);
+    QCOMPARE(left.buttons().first()->type(), DecorationButtonType::Close);
+    QCOMPARE(left.geometry(), QRectF(0, 0, 10, 10));
+
+    // from now on the group behaves like a non deferred one
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close, DecorationButtonType::Minimize});
+    QCOMPARE(created, 4);
+    QCOMPARE(left.buttons().count(), 2);
+    QCOMPARE(left.geometry(), QRectF(0, 0, 22, 10));
+}
+
+void DecorationButtonTest::testStateFlags()
+{
+    // the state is stored packed, changing one flag must not affect any other
+    MockBridge bridge;
+    MockDecoration mockDecoration(&bridge);
+    MockButton button(KDecoration2::DecorationButtonType::Custom, &mockDecoration);
+    button.setGeometry(QRect(0, 0, 10, 10));
+    QCOMPARE(button.isEnabled(), true);
+    QCOMPARE(button.isVisible(), true);
+    QCOMPARE(button.isCheckable(), false);
+    QCOMPARE(button.isChecked(), false);
+    QCOMPARE(button.isHovered(), false);
+    QCOMPARE(button.isPressed(), false);
+
+    button.setCheckable(true);
+    button.setChecked(true);
+    QCOMPARE(button.isEnabled(), true);
+    QCOMPARE(button.isVisible(), true);
+    QCOMPARE(button.isCheckable(), true);
+    QCOMPARE(button.isChecked(), true);
+
+    QHoverEvent enterEvent(QEvent::HoverEnter, QPointF(5, 5), QPointF(-1, -1));
+    QCoreApplication::sendEvent(&button, &enterEvent);
+    QMouseEvent pressEvent(QEvent::MouseButtonPress, QPointF(5, 5), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(&button, &pressEvent);
+    QCOMPARE(button.isHovered(), true);
+    QCOMPARE(button.isPressed(), true);
+    QCOMPARE(button.isChecked(), true);
+
+    // hiding resets hovered and pressed, but keeps the checked state
+    button.setVisible(false);
+    QCOMPARE(button.isVisible(), false);
+    QCOMPARE(button.isHovered(), false);
+    QCOMPARE(button.isPressed(), false);
+    QCOMPARE(button.isEnabled(), true);
+    QCOMPARE(button.isCheckable(), true);
+    QCOMPARE(button.isChecked(), true);
+
+    button.setEnabled(false);
+    button.setVisible(true);
+    QCOMPARE(button.isEnabled(), false);
+    QCOMPARE(button.isVisible(), true);
+    QCOMPARE(button.isChecked(), true);
+
+    button.setCheckable(false);
+    QCOMPARE(button.isCheckable(), false);
+    QCOMPARE(button.isChecked(), false);
+    QCOMPARE(button.isEnabled(), false);
+    QCOMPARE(button.isVisible(), true);
+}
+
+void DecorationButtonTest::testDevicePixelRatio()
+{
+    using namespace KDecoration2;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    settings->setDecorationButtonsLeft({DecorationButtonType::Close, DecorationButtonType::Minimize});
+    MockDecoration mockDecoration(&bridge);
+    mockDecoration.setSettings(decoSettings);
+    QCOMPARE(mockDecoration.devicePixelRatio(), 1.0);
+    QSignalSpy devicePixelRatioChangedSpy(&mockDecoration, &Decoration::devicePixelRatioChanged);
+    QVERIFY(devicePixelRatioChangedSpy.isValid());
+
+    auto creator = [](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+        auto button = new MockButton(type, decoration, parent);
+        button->setGeometry(QRectF(0, 0, 10, 10));
+        return button;
+    };
+    DecorationButtonGroup group(DecorationButtonGroup::Position::Left, &mockDecoration, creator);
+    group.setSpacing(0.5);
+    const auto buttons = group.buttons();
+    QCOMPARE(buttons.count(), 2);
+    // without scale the layout is not changed
+    QCOMPARE(buttons.at(0)->geometry(), QRectF(0, 0, 10, 10));
+    QCOMPARE(buttons.at(1)->geometry(), QRectF(10.5, 0, 10, 10));
+
+    // on a fractional scale the edges are snapped to physical pixels
+    mockDecoration.setDevicePixelRatio(1.5);
+    QCOMPARE(devicePixelRatioChangedSpy.count(), 1);
+    QCOMPARE(devicePixelRatioChangedSpy.first().first().toReal(), 1.5);
+    QCOMPARE(buttons.at(0)->geometry(), QRectF(0, 0, 10, 10));
+    QCOMPARE(buttons.at(1)->geometry().left() * 1.5, 16.0);
+    QCOMPARE(buttons.at(1)->geometry().right() * 1.5, 31.0);
+    QCOMPARE(group.geometry().right() * 1.5, 31.0);
+    mockDecoration.setDevicePixelRatio(1.5);
+    QCOMPARE(devicePixelRatioChangedSpy.count(), 1);
+
+    // the position as set is kept, setting it again does not lay out again
+    group.setPos(QPointF(0.4, 0.4));
+    QCOMPARE(group.geometry().left() * 1.5, 1.0);
+    const qint64 layouts = DecorationCounters::snapshot().layouts;
+    group.setPos(QPointF(0.4, 0.4));
+    QCOMPARE(DecorationCounters::snapshot().layouts, layouts);
+    group.setPos(QPointF(0, 0));
+    QCOMPARE(group.geometry().left(), 0.0);
+
+    // damage is passed in physical pixels
+    mockDecoration.update(QRect(1, 1, 3, 3));
+    QCOMPARE(bridge.lastScaledUpdate(), QRect(1, 1, 5, 5));
+    QCOMPARE(bridge.lastScale(), 1.5);
+    buttons.at(1)->update();
+    QCOMPARE(bridge.lastScaledUpdate(), QRect(16, 0, 15, 15));
+    // the default implementation falls back to logical coordinates covering the damage
+    bridge.DecorationBridge::updateScaled(&mockDecoration, QRect(1, 1, 5, 5), 1.5);
+    QCOMPARE(bridge.lastUpdate(), QRect(0, 0, 4, 4));
+
+    // without scale the damage is passed as before
+    mockDecoration.setDevicePixelRatio(1.0);
+    mockDecoration.update(QRect(1, 1, 3, 3));
+    QCOMPARE(bridge.lastUpdate(), QRect(1, 1, 3, 3));
+}
+
 QTEST_MAIN(DecorationButtonTest)
 #include "decorationbuttontest.moc"
@@ -0,0 +1,360 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationbuttongroup.h"
+#include "../src/decorationsettings.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include "mocksettings.h"
+#include <QDebug>
+#include <QFile>
+#include <QGuiApplication>
+#include <QHoverEvent>
+#include <QRandomGenerator>
+
+#include <cstdint>
+
+using namespace KDecoration2;
+
+/**
+ * Builds a Decoration with borders, title bar and button geometries taken from the fuzzer's
+ * input, sends it the event sequence described by the rest of the input and checks after
+ * each event that
+ * @li the section under the mouse is consistent with the geometry
+ * @li at most one DecorationButton is hovered and only if it contains the pointer
+ * @li no DecorationButton stays pressed once all mouse buttons got released
+ *
+ * Built with KDECORATION2_BUILD_FUZZERS this is a libFuzzer target, otherwise it checks a
+ * fixed set of pseudo random inputs and the inputs passed as files on the command line.
+ **/
+namespace
+{
+class Input
+{
+public:
+    Input(const uint8_t *data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+    bool atEnd() const
+    {
+        return m_position >= m_size;
+    }
+    quint8 byte()
+    {
+        return atEnd() ? 0 : m_data[m_position++];
+    }
+    quint16 word()
+    {
+        return quint16(byte() << 8 | byte());
+    }
+
+private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_position = 0;
+};
+
+const DecorationButtonType s_buttonTypes[] = {
+    DecorationButtonType::Menu,
+    DecorationButtonType::ApplicationMenu,
+    DecorationButtonType::OnAllDesktops,
+    DecorationButtonType::Minimize,
+    DecorationButtonType::Maximize,
+    DecorationButtonType::Close,
+    DecorationButtonType::ContextHelp,
+    DecorationButtonType::Shade,
+    DecorationButtonType::KeepBelow,
+    DecorationButtonType::KeepAbove,
+    DecorationButtonType::Custom,
+};
+
+const Qt::MouseButton s_mouseButtons[] = {Qt::LeftButton, Qt::RightButton, Qt::MiddleButton};
+
+QVector<DecorationButtonType> buttonTypes(Input &input, int maximum)
+{
+    QVector<DecorationButtonType> types;
+    const int count = input.byte() % (maximum + 1);
+    for (int i = 0; i < count; ++i) {
+        types << s_buttonTypes[input.byte() % (sizeof(s_buttonTypes) / sizeof(s_buttonTypes[0]))];
+    }
+    return types;
+}
+
+#define CHECK(condition)                                                                                                                                       \
+    do {                                                                                                                                                       \
+        if (!(condition)) {                                                                                                                                    \
+            qFatal("invariant violated: %s", #condition);                                                                                                      \
+        }                                                                                                                                                      \
+    } while (false)
+
+class Fuzzer
+{
+public:
+    explicit Fuzzer(Input &input);
+    void run();
+
+private:
+    void send(QEvent *event);
+    void checkButtons() const;
+    void checkSection(const QPointF &position) const;
+
+    Input &m_input;
+    MockBridge m_bridge;
+    QSharedPointer<DecorationSettings> m_settings;
+    QScopedPointer<MockDecoration> m_decoration;
+    QVector<DecorationButton *> m_buttons;
+    QPointF m_position;
+    bool m_hovered = false;
+    Qt::MouseButtons m_pressed;
+};
+
+Fuzzer::Fuzzer(Input &input)
+    : m_input(input)
+    , m_settings(QSharedPointer<DecorationSettings>::create(&m_bridge))
+{
+    MockSettings *settings = m_bridge.lastCreatedSettings();
+    settings->setDecorationButtonsLeft(buttonTypes(input, 4));
+    settings->setDecorationButtonsRight(buttonTypes(input, 6));
+
+    m_decoration.reset(new MockDecoration(&m_bridge));
+    m_decoration->setSettings(m_settings);
+    MockClient *client = m_bridge.lastCreatedClient();
+    client->setWidth(input.word() % 2048);
+    client->setHeight(input.word() % 2048);
+    m_decoration->setBorders(QMargins(input.byte() % 32, input.byte() % 64, input.byte() % 32, input.byte() % 32));
+    m_decoration->setTitleBar(QRect(int(input.byte() % 64) - 32, int(input.byte() % 64) - 32, input.word() % 2048, input.byte() % 64));
+
+    // the groups lay their buttons out next to each other, the right group after the left one
+    const QSizeF buttonSize(1 + input.byte() % 32, 1 + input.byte() % 32);
+    auto creator = [buttonSize](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+        auto button = new MockButton(type, decoration, parent);
+        button->setGeometry(QRectF(QPointF(0, 0), buttonSize));
+        return button;
+    };
+    auto left = new DecorationButtonGroup(DecorationButtonGroup::Position::Left, m_decoration.data(), creator);
+    auto right = new DecorationButtonGroup(DecorationButtonGroup::Position::Right, m_decoration.data(), creator);
+    left->setSpacing(input.byte() % 8);
+    right->setSpacing(input.byte() % 8);
+    left->setPos(QPointF(int(input.byte() % 64) - 8, int(input.byte() % 64) - 8));
+    right->setPos(QPointF(left->geometry().right() + input.byte() % 256, left->pos().y() + int(input.byte() % 16) - 8));
+
+    for (const auto &button : left->buttons() + right->buttons()) {
+        m_buttons << button.data();
+        const quint8 flags = input.byte();
+        button->setEnabled(flags & 1);
+        button->setVisible(flags & 2);
+    }
+}
+
+void Fuzzer::send(QEvent *event)
+{
+    QCoreApplication::sendEvent(m_decoration.data(), event);
+}
+
+void Fuzzer::run()
+{
+    const QSize size = m_decoration->size();
+    for (int events = 0; events < 512 && !m_input.atEnd(); ++events) {
+        const quint8 op = m_input.byte();
+        switch (op % 6) {
+        case 0: {
+            // positions slightly outside of the Decoration, with fractional parts
+            const QPointF position(int(m_input.word() % (size.width() + 64)) - 32 + m_input.byte() / 256.0,
+                                   int(m_input.word() % (size.height() + 64)) - 32 + m_input.byte() / 256.0);
+            if (!m_hovered) {
+                m_hovered = true;
+                QHoverEvent enter(QEvent::HoverEnter, position, position);
+                send(&enter);
+            }
+            QHoverEvent move(QEvent::HoverMove, position, m_position);
+            m_position = position;
+            send(&move);
+            checkButtons();
+            checkSection(position);
+            if (m_pressed != Qt::NoButton) {
+                QMouseEvent drag(QEvent::MouseMove, m_position, Qt::NoButton, m_pressed, Qt::NoModifier);
+                send(&drag);
+            }
+            break;
+        }
+        case 1:
+        case 2: {
+            const Qt::MouseButton button = s_mouseButtons[m_input.byte() % 3];
+            const bool press = op % 6 == 1;
+            if (m_pressed.testFlag(button) == press) {
+                break;
+            }
+            m_pressed.setFlag(button, press);
+            QMouseEvent event(press ? QEvent::MouseButtonPress : QEvent::MouseButtonRelease, m_position, button, m_pressed, Qt::NoModifier);
+            send(&event);
+            break;
+        }
+        case 3: {
+            QWheelEvent event(m_position, m_position, QPoint(), QPoint(0, int(m_input.byte()) - 128), m_pressed, Qt::NoModifier, Qt::NoScrollPhase, false);
+            send(&event);
+            break;
+        }
+        case 4:
+            if (m_hovered) {
+                m_hovered = false;
+                QHoverEvent leave(QEvent::HoverLeave, QPointF(), m_position);
+                send(&leave);
+                CHECK(m_decoration->sectionUnderMouse() == Qt::NoSection);
+                for (const DecorationButton *button : qAsConst(m_buttons)) {
+                    CHECK(!button->isHovered());
+                }
+            }
+            break;
+        case 5: {
+            // a window moving to an output with a different scale
+            const qreal scales[] = {1.0, 1.25, 1.5, 2.0};
+            m_decoration->setDevicePixelRatio(scales[m_input.byte() % 4]);
+            break;
+        }
+        }
+        checkButtons();
+    }
+
+    for (Qt::MouseButton button : s_mouseButtons) {
+        if (m_pressed.testFlag(button)) {
+            m_pressed.setFlag(button, false);
+            QMouseEvent release(QEvent::MouseButtonRelease, m_position, button, m_pressed, Qt::NoModifier);
+            send(&release);
+        }
+    }
+    for (const DecorationButton *button : qAsConst(m_buttons)) {
+        CHECK(!button->isPressed());
+    }
+}
+
+void Fuzzer::checkButtons() const
+{
+    int hovered = 0;
+    for (const DecorationButton *button : qAsConst(m_buttons)) {
+        if (button->isHovered()) {
+            hovered++;
+            CHECK(button->isEnabled() && button->isVisible());
+        }
+    }
+    CHECK(hovered <= 1);
+}
+
+void Fuzzer::checkSection(const QPointF &position) const
+{
+    for (const DecorationButton *button : qAsConst(m_buttons)) {
+        if (button->isHovered()) {
+            CHECK(button->contains(position));
+        }
+    }
+
+    // the section is computed on integer positions
+    const QPoint pos = position.toPoint();
+    const QRect titleBar = m_decoration->titleBar();
+    const QMargins borders = m_decoration->borders();
+    const QSize size = m_decoration->size();
+    const int corner = 2 * m_settings->largeSpacing();
+    const bool left = pos.x() < borders.left();
+    const bool right = size.width() - pos.x() <= borders.right();
+    const bool top = pos.y() < borders.top();
+    const bool bottom = size.height() - pos.y() <= borders.bottom();
+
+    const Qt::WindowFrameSection section = m_decoration->sectionUnderMouse();
+    if (titleBar.contains(pos)) {
+        CHECK(section == Qt::TitleBarArea);
+        return;
+    }
+    switch (section) {
+    case Qt::NoSection:
+        CHECK(!left && !right && !top && !bottom);
+        break;
+    case Qt::TitleBarArea:
+        CHECK(top || bottom);
+        break;
+    case Qt::LeftSection:
+        CHECK(left);
+        break;
+    case Qt::RightSection:
+        CHECK(right && !left);
+        break;
+    case Qt::TopSection:
+        CHECK(top && !left && !right && pos.y() < titleBar.top());
+        break;
+    case Qt::BottomSection:
+        CHECK(bottom && !left && !right && pos.y() > titleBar.bottom());
+        break;
+    case Qt::TopLeftSection:
+        CHECK(top && pos.x() < borders.left() + corner);
+        break;
+    case Qt::TopRightSection:
+        CHECK(top && !left && size.width() - pos.x() <= borders.right() + corner);
+        break;
+    case Qt::BottomLeftSection:
+        CHECK(pos.x() < borders.left() + corner && size.height() - pos.y() <= borders.bottom() + corner && pos.y() > titleBar.bottom());
+        break;
+    case Qt::BottomRightSection:
+        CHECK(!left && size.width() - pos.x() <= borders.right() + corner && size.height() - pos.y() <= borders.bottom() + corner && pos.y() > titleBar.bottom());
+        break;
+    default:
+        CHECK(false);
+    }
+}
+
+QGuiApplication *createApplication(int *argc, char **argv)
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    return new QGuiApplication(*argc, argv);
+}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    Input input(data, size);
+    Fuzzer fuzzer(input);
+    fuzzer.run();
+    return 0;
+}
+
+#ifdef KDECORATION2_LIBFUZZER
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    createApplication(argc, *argv);
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+    QScopedPointer<QGuiApplication> app(createApplication(&argc, argv));
+    const QStringList files = app->arguments().mid(1);
+    for (const QString &fileName : files) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Could not open" << fileName;
+            return 1;
+        }
+        const QByteArray data = file.readAll();
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.constData()), data.size());
+    }
+    if (files.isEmpty()) {
+        // the same inputs on every run
+        QRandomGenerator generator(42);
+        for (int i = 0; i < 2000; ++i) {
+            QByteArray data(64 + generator.bounded(1024), 0);
+            generator.fillRange(reinterpret_cast<quint32 *>(data.data()), data.size() / sizeof(quint32));
+            LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.constData()), data.size());
+        }
+    }
+    return 0;
+}
+
+#endif
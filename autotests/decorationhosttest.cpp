@@ -0,0 +1,367 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decoratedclient.h"
+#include "../src/decorationhost.h"
+#include "../src/decorationhostconnection.h"
+#include "../src/decorationsettings.h"
+#include "mockdecoration.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace KDecoration2;
+
+class HostDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    using MockDecoration::MockDecoration;
+    void init() override
+    {
+        Decoration::init();
+        auto c = client().toStrongRef();
+        setBorders(QMargins(4, 24, 4, 4));
+        setTitleBar(QRect(0, 0, c->width(), 24));
+        connect(c.data(), &DecoratedClient::captionChanged, this, [this] {
+            update(titleBar());
+        });
+        connect(c.data(), &DecoratedClient::widthChanged, this, [this](int width) {
+            setTitleBar(QRect(0, 0, width, 24));
+        });
+    }
+
+    int m_hoverMoves = 0;
+    QPointF m_lastHover;
+
+protected:
+    void hoverMoveEvent(QHoverEvent *event) override
+    {
+        m_hoverMoves++;
+        m_lastHover = event->posF();
+        update(QRect(event->pos(), QSize(1, 1)));
+    }
+    void mousePressEvent(QMouseEvent *event) override
+    {
+        if (event->button() == Qt::LeftButton) {
+            requestClose();
+        }
+    }
+};
+
+/**
+ * Stands in for the helper process, the test acts as the compositor.
+ **/
+class HostThread : public QThread
+{
+public:
+    explicit HostThread(int socket)
+        : m_socket(socket)
+    {
+    }
+    DecorationHost *host() const
+    {
+        return m_host;
+    }
+
+protected:
+    void run() override
+    {
+        DecorationHost host(m_socket, [](QObject *parent, const QVariantList &args) {
+            return new HostDecoration(parent, args);
+        });
+        connect(&host, &DecorationHost::disconnected, &host, [] {
+            QThread::currentThread()->quit();
+        });
+        m_host = &host;
+        exec();
+        m_host = nullptr;
+    }
+
+private:
+    int m_socket;
+    DecorationHost *m_host = nullptr;
+};
+
+class Host
+{
+public:
+    Host()
+    {
+        int sockets[2];
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets);
+        thread.reset(new HostThread(sockets[1]));
+        thread->start();
+        connection.reset(new DecorationHostConnection(sockets[0]));
+    }
+    ~Host()
+    {
+        // the host quits once the connection is closed
+        connection.reset();
+        thread->wait();
+    }
+    HostDecoration *decoration(quint32 id) const
+    {
+        return qobject_cast<HostDecoration *>(thread->host()->decoration(id));
+    }
+
+    QScopedPointer<HostThread> thread;
+    QScopedPointer<DecorationHostConnection> connection;
+};
+
+class DecorationHostTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testState();
+    void testEvents();
+    void testStalledHost();
+    void testOversizedBatch();
+    void testInvalidRequest();
+    void benchmarkRoundTrip();
+    void benchmarkThroughput();
+};
+
+void DecorationHostTest::testState()
+{
+    Host host;
+    DecorationHostConnection *connection = host.connection.data();
+    QSignalSpy geometrySpy(connection, &DecorationHostConnection::geometryChanged);
+    QVERIFY(geometrySpy.isValid());
+    QSignalSpy damageSpy(connection, &DecorationHostConnection::damaged);
+    QVERIFY(damageSpy.isValid());
+
+    DecorationHostSettingsState settings;
+    settings.borderSize = BorderSize::Large;
+    connection->setSettings(settings);
+    DecorationHostClientState state;
+    state.caption = QStringLiteral("foo");
+    state.size = QSize(200, 100);
+    state.active = true;
+    state.closeable = true;
+    const quint32 id = connection->createDecoration(state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QCOMPARE(geometrySpy.count(), 1);
+    QCOMPARE(connection->borders(id), QMargins(4, 24, 4, 4));
+    QCOMPARE(connection->titleBar(id), QRect(0, 0, 200, 24));
+
+    // the host thread is idle until the next frame
+    HostDecoration *deco = host.decoration(id);
+    QVERIFY(deco);
+    auto client = deco->client().toStrongRef();
+    QCOMPARE(client->caption(), QStringLiteral("foo"));
+    QVERIFY(client->isActive());
+    QVERIFY(client->isCloseable());
+    QVERIFY(!client->isMinimizeable());
+    QCOMPARE(client->size(), QSize(200, 100));
+    QCOMPARE(deco->settings()->borderSize(), BorderSize::Large);
+
+    // only the changed caption gets sent
+    const qint64 bytes = connection->bytesWritten();
+    state.caption = QStringLiteral("bar");
+    connection->setClientState(id, state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QVERIFY(connection->bytesWritten() - bytes < 40);
+    QCOMPARE(client->caption(), QStringLiteral("bar"));
+    QVERIFY(!damageSpy.isEmpty());
+    QCOMPARE(damageSpy.last().at(0).value<quint32>(), id);
+    QCOMPARE(damageSpy.last().at(1).value<qreal>(), 1.0);
+    QCOMPARE(damageSpy.last().at(2).value<QRegion>(), QRegion(0, 0, 200, 24));
+
+    state.size = QSize(300, 100);
+    connection->setClientState(id, state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QCOMPARE(geometrySpy.count(), 2);
+    QCOMPARE(connection->titleBar(id), QRect(0, 0, 300, 24));
+
+    // the decoration colors and the icon
+    QSignalSpy iconChangedSpy(client.data(), &DecoratedClient::iconChanged);
+    QVERIFY(iconChangedSpy.isValid());
+    state.colors.resize(9);
+    state.colors[DecorationHostClientState::colorIndex(ColorGroup::Active, ColorRole::TitleBar)] = Qt::blue;
+    QPixmap icon(16, 16);
+    icon.fill(Qt::red);
+    state.icon = icon;
+    connection->setClientState(id, state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QCOMPARE(client->color(ColorGroup::Active, ColorRole::TitleBar), QColor(Qt::blue));
+    QVERIFY(!client->color(ColorGroup::Inactive, ColorRole::TitleBar).isValid());
+    QCOMPARE(iconChangedSpy.count(), 1);
+    QCOMPARE(client->icon().pixmap(16, 16).toImage().pixelColor(0, 0), QColor(Qt::red));
+    // an unchanged pixmap is not sent again
+    const qint64 iconBytes = connection->bytesWritten();
+    connection->setClientState(id, state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QVERIFY(connection->bytesWritten() - iconBytes < 40);
+
+    // nothing changed, only the frame gets sent
+    const quint32 serial = connection->flush();
+    QVERIFY(connection->waitForFrame(serial, 5000));
+    QCOMPARE(connection->lastFrame(), serial);
+
+    connection->destroyDecoration(id);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QCOMPARE(host.thread->host()->decorationCount(), 0);
+}
+
+void DecorationHostTest::testEvents()
+{
+    Host host;
+    DecorationHostConnection *connection = host.connection.data();
+    QSignalSpy requestSpy(connection, &DecorationHostConnection::requested);
+    QVERIFY(requestSpy.isValid());
+
+    DecorationHostClientState state;
+    state.size = QSize(200, 100);
+    const quint32 id = connection->createDecoration(state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+
+    // hover moves of one frame are coalesced
+    for (int i = 0; i < 10; ++i) {
+        connection->hoverMove(id, QPointF(i, 10));
+    }
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    HostDecoration *deco = host.decoration(id);
+    QCOMPARE(deco->m_hoverMoves, 1);
+    QCOMPARE(deco->m_lastHover, QPointF(9, 10));
+
+    connection->mousePress(id, QPointF(9, 10), Qt::LeftButton);
+    connection->mouseRelease(id, QPointF(9, 10), Qt::LeftButton);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QCOMPARE(requestSpy.count(), 1);
+    QCOMPARE(requestSpy.first().at(0).value<quint32>(), id);
+    QCOMPARE(requestSpy.first().at(1).value<DecorationHostConnection::Request>(), DecorationHostConnection::Request::Close);
+
+    // events of unknown Decorations are dropped
+    connection->hoverMove(id + 1, QPointF(0, 0));
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    QVERIFY(connection->isConnected());
+}
+
+void DecorationHostTest::testStalledHost()
+{
+    // a host which never reads must neither block nor grow the compositor's memory
+    int sockets[2];
+    QCOMPARE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), 0);
+    DecorationHostConnection connection(sockets[0]);
+    QSignalSpy disconnectedSpy(&connection, &DecorationHostConnection::disconnected);
+    QVERIFY(disconnectedSpy.isValid());
+
+    DecorationHostClientState state;
+    state.caption = QString(1024 * 1024, QLatin1Char('x'));
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 64 && connection.isConnected(); ++i) {
+        connection.createDecoration(state);
+        connection.flush();
+    }
+    QVERIFY(timer.elapsed() < 5000);
+    QVERIFY(!connection.isConnected());
+    QCOMPARE(disconnectedSpy.count(), 1);
+    close(sockets[1]);
+}
+
+void DecorationHostTest::testOversizedBatch()
+{
+    int sockets[2];
+    QCOMPARE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), 0);
+    DecorationHostConnection connection(sockets[0]);
+    QSignalSpy disconnectedSpy(&connection, &DecorationHostConnection::disconnected);
+    QVERIFY(disconnectedSpy.isValid());
+
+    // a length prefix beyond the protocol maximum closes the connection without buffering
+    const quint32 size = 0xffffffff;
+    QCOMPARE(write(sockets[1], &size, sizeof(size)), ssize_t(sizeof(size)));
+    QVERIFY(disconnectedSpy.wait());
+    QVERIFY(!connection.isConnected());
+    close(sockets[1]);
+}
+
+void DecorationHostTest::testInvalidRequest()
+{
+    int sockets[2];
+    QCOMPARE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), 0);
+    DecorationHostConnection connection(sockets[0]);
+    QSignalSpy requestSpy(&connection, &DecorationHostConnection::requested);
+    QVERIFY(requestSpy.isValid());
+    QSignalSpy disconnectedSpy(&connection, &DecorationHostConnection::disconnected);
+    QVERIFY(disconnectedSpy.isValid());
+    const quint32 id = connection.createDecoration(DecorationHostClientState());
+    connection.flush();
+
+    // a Request message with a request beyond the known ones
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << quint8(66) << id << quint8(200);
+    const quint32 size = payload.size();
+    payload.prepend(reinterpret_cast<const char *>(&size), sizeof(size));
+    QCOMPARE(write(sockets[1], payload.constData(), payload.size()), ssize_t(payload.size()));
+    QVERIFY(disconnectedSpy.wait());
+    QVERIFY(requestSpy.isEmpty());
+    close(sockets[1]);
+}
+
+void DecorationHostTest::benchmarkRoundTrip()
+{
+    Host host;
+    DecorationHostConnection *connection = host.connection.data();
+    DecorationHostClientState state;
+    state.size = QSize(200, 100);
+    const quint32 id = connection->createDecoration(state);
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+
+    const int frames = 1000;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i) {
+        connection->hoverMove(id, QPointF(i % 200, 10));
+        QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+    }
+    qInfo() << "frame round trip:" << timer.nsecsElapsed() / frames / 1000 << "us";
+}
+
+void DecorationHostTest::benchmarkThroughput()
+{
+    Host host;
+    DecorationHostConnection *connection = host.connection.data();
+    DecorationHostClientState state;
+    state.size = QSize(200, 100);
+    QVector<quint32> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids << connection->createDecoration(state);
+    }
+    QVERIFY(connection->waitForFrame(connection->flush(), 5000));
+
+    // every Decoration gets an event in every frame, the next frame is sent while the host
+    // still processes the previous one
+    const int frames = 200;
+    const qint64 bytes = connection->bytesWritten();
+    QElapsedTimer timer;
+    timer.start();
+    quint32 serial = 0;
+    for (int i = 0; i < frames; ++i) {
+        for (quint32 id : qAsConst(ids)) {
+            connection->hoverMove(id, QPointF(i % 200, 10));
+        }
+        serial = connection->flush();
+        QVERIFY(connection->waitForFrame(serial - 1, 10000));
+    }
+    QVERIFY(connection->waitForFrame(serial, 10000));
+    const qint64 elapsed = qMax<qint64>(1, timer.nsecsElapsed());
+    qInfo() << "events per second:" << qint64(frames) * ids.count() * 1000000000 / elapsed;
+    qInfo() << "bytes per frame:" << (connection->bytesWritten() - bytes) / frames;
+    QCOMPARE(host.decoration(ids.last())->m_hoverMoves, frames);
+}
+
+QTEST_MAIN(DecorationHostTest)
+#include "decorationhosttest.moc"
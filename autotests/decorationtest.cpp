@@ -3,15 +3,22 @@
  *
  * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
  */
+#include "../src/decoratedclient.h"
+#include "../src/decorationbuttongroup.h"
+#include "../src/decorationcounters.h"
 #include "../src/decorationsettings.h"
 #include "mockbridge.h"
+#include "mockbutton.h"
 #include "mockclient.h"
 #include "mockdecoration.h"
 #include "mocksettings.h"
+#include <QPainter>
 #include <QSignalSpy>
 #include <QTest>
 #include <QVariant>
 
+#include <memory>
+
 class DecorationTest : public QObject
 {
     Q_OBJECT
@@ -20,8 +27,33 @@ private Q_SLOTS:
     void testOpaque();
     void testSection_data();
     void testSection();
+    void testRecycle();
+    void testRecyclePoolSize();
+    void testColorCache();
+    void testIconCache();
+    void testScales();
+    void testMemoryUsage();
+    void testSettingsChanged();
+    void testToolTips();
+    void benchmarkCreate();
+    void benchmarkRecycle();
 };
 
+namespace
+{
+void createButtons(KDecoration2::Decoration *deco)
+{
+    using KDecoration2::DecorationButtonType;
+    for (auto type : {DecorationButtonType::Menu,
+                      DecorationButtonType::OnAllDesktops,
+                      DecorationButtonType::Minimize,
+                      DecorationButtonType::Maximize,
+                      DecorationButtonType::Close}) {
+        new MockButton(type, deco, deco);
+    }
+}
+}
+
 #ifdef _MSC_VER
 QMap<QString, QVariant> makeMap(const QString &key, const QVariant &value);
 #endif
@@ -147,5 +179,495 @@ void DecorationTest::testSection()
     QCOMPARE(spy.last().first().value<Qt::WindowFrameSection>(), Qt::NoSection);
 }
 
+void DecorationTest::testRecycle()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    QObject window;
+    QPointer<MockDecoration> deco = new MockDecoration(&bridge);
+    deco->setParent(&window);
+    deco->setSettings(decoSettings);
+    MockButton *button = new MockButton(KDecoration2::DecorationButtonType::Close, deco.data(), deco.data());
+    button->setGeometry(QRect(0, 0, 10, 10));
+
+    MockClient *client = bridge.lastCreatedClient();
+    client->setCloseable(true);
+    QCOMPARE(button->isEnabled(), true);
+    QHoverEvent moveEvent(QEvent::HoverMove, QPointF(5, 5), QPointF(5, 5));
+    QCoreApplication::sendEvent(deco.data(), &moveEvent);
+    QCOMPARE(button->isHovered(), true);
+
+    deco->setBorders(QMargins(2, 20, 2, 2));
+    deco->setTitleBar(QRect(0, 0, 100, 20));
+    deco->setScales({1.0, 2.0});
+    QImage image(200, 200, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    deco->render(&painter, deco->rect(), 2.0);
+    deco->update();
+    QVERIFY(!deco->damage(2.0).isEmpty());
+
+    // recycling hands the decoration to the pool and resets the input state
+    QSignalSpy hoveredChangedSpy(button, &KDecoration2::DecorationButton::hoveredChanged);
+    QVERIFY(hoveredChangedSpy.isValid());
+    deco->recycle();
+    QVERIFY(!deco.isNull());
+    QVERIFY(!deco->parent());
+    QCOMPARE(button->isHovered(), false);
+    QCOMPARE(hoveredChangedSpy.count(), 1);
+    QCOMPARE(deco->sectionUnderMouse(), Qt::NoSection);
+    // and everything the previous window set up
+    QCOMPARE(deco->borders(), QMargins());
+    QCOMPARE(deco->titleBar(), QRect());
+    QVERIFY(deco->shadow().isNull());
+    QCOMPARE(deco->scales(), QVector<qreal>{1.0});
+    QCOMPARE(deco->devicePixelRatio(), 1.0);
+    deco->update();
+    QVERIFY(deco->damage(1.0).isEmpty());
+    // the window is gone, the client reports defaults
+    QCOMPARE(deco->client().toStrongRef()->isCloseable(), false);
+    QCOMPARE(deco->client().toStrongRef()->width(), 0);
+
+    // taking it out of the pool and rebinding uses a new backend
+    QCOMPARE(bridge.takeRecycledDecoration(), static_cast<QObject *>(deco.data()));
+    QVERIFY(!bridge.takeRecycledDecoration());
+    QSignalSpy closeableChangedSpy(deco->client().toStrongRef().data(), &KDecoration2::DecoratedClient::closeableChanged);
+    QVERIFY(closeableChangedSpy.isValid());
+    QObject newWindow;
+    deco->rebind(&newWindow);
+    QCOMPARE(deco->parent(), &newWindow);
+    QVERIFY(bridge.lastCreatedClient() != client);
+    QCOMPARE(closeableChangedSpy.count(), 1);
+    QCOMPARE(button->isEnabled(), false);
+    bridge.lastCreatedClient()->setCloseable(true);
+    QCOMPARE(button->isEnabled(), true);
+    QCOMPARE(deco->client().toStrongRef()->decoration().data(), deco.data());
+    delete deco.data();
+}
+
+void DecorationTest::testRecyclePoolSize()
+{
+    MockBridge bridge;
+    QCOMPARE(bridge.recyclePoolSize(), 8);
+    bridge.setRecyclePoolSize(1);
+    QCOMPARE(bridge.recyclePoolSize(), 1);
+
+    QPointer<MockDecoration> deco1 = new MockDecoration(&bridge);
+    QPointer<MockDecoration> deco2 = new MockDecoration(&bridge);
+    deco1->recycle();
+    QVERIFY(!deco1.isNull());
+    // the pool is full, so the second one gets deleted
+    deco2->recycle();
+    QVERIFY(deco2.isNull());
+
+    // shrinking the pool deletes the surplus
+    bridge.setRecyclePoolSize(0);
+    QVERIFY(deco1.isNull());
+    QVERIFY(!bridge.takeRecycledDecoration());
+
+    // decorations left in the pool get deleted with the bridge
+    QPointer<MockDecoration> deco3;
+    {
+        MockBridge bridge2;
+        deco3 = new MockDecoration(&bridge2);
+        deco3->recycle();
+        QVERIFY(!deco3.isNull());
+    }
+    QVERIFY(deco3.isNull());
+}
+
+void DecorationTest::testColorCache()
+{
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    auto decoratedClient = deco.client().toStrongRef();
+    QVERIFY(decoratedClient);
+
+    QPalette palette;
+    palette.setColor(QPalette::Active, QPalette::Window, Qt::red);
+    palette.setColor(QPalette::Inactive, QPalette::Window, Qt::green);
+    client->setPalette(palette);
+    const int requests = client->paletteRequests();
+
+    // the first lookup builds the table, further lookups don't need the palette
+    QCOMPARE(decoratedClient->color(QPalette::Active, QPalette::Window), QColor(Qt::red));
+    QCOMPARE(decoratedClient->color(QPalette::Inactive, QPalette::Window), QColor(Qt::green));
+    QCOMPARE(decoratedClient->color(QPalette::Disabled, QPalette::Text), palette.color(QPalette::Disabled, QPalette::Text));
+    QCOMPARE(client->paletteRequests(), requests + 1);
+
+    // QPalette::Current is resolved by the palette
+    QCOMPARE(decoratedClient->color(QPalette::Current, QPalette::Window), QColor(Qt::red));
+
+    // a palette change updates the colors for everyone listening
+    QColor colorInSlot;
+    KDecoration2::DecoratedClient *c = decoratedClient.data();
+    connect(c, &KDecoration2::DecoratedClient::paletteChanged, this, [&colorInSlot, c] {
+        colorInSlot = c->color(QPalette::Active, QPalette::Window);
+    });
+    palette.setColor(QPalette::Active, QPalette::Window, Qt::blue);
+    client->setPalette(palette);
+    QCOMPARE(colorInSlot, QColor(Qt::blue));
+    QCOMPARE(decoratedClient->color(QPalette::Active, QPalette::Window), QColor(Qt::blue));
+
+    // the mock does not provide decoration colors
+    QVERIFY(!decoratedClient->color(KDecoration2::ColorGroup::Active, KDecoration2::ColorRole::TitleBar).isValid());
+    QVERIFY(!decoratedClient->color(KDecoration2::ColorGroup::Warning, KDecoration2::ColorRole::Foreground).isValid());
+}
+
+void DecorationTest::testIconCache()
+{
+    MockBridge bridge;
+    MockDecoration deco(&bridge);
+    MockClient *client = bridge.lastCreatedClient();
+    auto decoratedClient = deco.client().toStrongRef();
+    QVERIFY(decoratedClient);
+
+    QPixmap red(64, 64);
+    red.fill(Qt::red);
+    client->setIcon(QIcon(red));
+    const int requests = client->iconRequests();
+
+    const QPixmap pixmap = decoratedClient->iconPixmap(QSize(16, 16), 2.0);
+    QCOMPARE(pixmap.size(), QSize(32, 32));
+    QCOMPARE(pixmap.devicePixelRatio(), 2.0);
+    QCOMPARE(pixmap.toImage().pixelColor(0, 0), QColor(Qt::red));
+    QCOMPARE(client->iconRequests(), requests + 1);
+
+    // cached per size, device pixel ratio, mode and state
+    QCOMPARE(decoratedClient->iconPixmap(QSize(16, 16), 2.0).cacheKey(), pixmap.cacheKey());
+    QCOMPARE(client->iconRequests(), requests + 1);
+    QCOMPARE(decoratedClient->iconPixmap(QSize(16, 16), 1.0).size(), QSize(16, 16));
+    QCOMPARE(decoratedClient->iconPixmap(QSize(16, 16), 2.0, QIcon::Disabled).size(), QSize(32, 32));
+    QCOMPARE(client->iconRequests(), requests + 3);
+
+    // changing the icon renders the used pixmaps again once the event loop runs
+    QPixmap blue(64, 64);
+    blue.fill(Qt::blue);
+    client->setIcon(QIcon(blue));
+    QCoreApplication::processEvents();
+    QCOMPARE(client->iconRequests(), requests + 4);
+    const QPixmap changed = decoratedClient->iconPixmap(QSize(16, 16), 2.0);
+    QCOMPARE(changed.toImage().pixelColor(0, 0), QColor(Qt::blue));
+    QCOMPARE(decoratedClient->iconPixmap(QSize(16, 16), 1.0).size(), QSize(16, 16));
+    QCOMPARE(client->iconRequests(), requests + 4);
+}
+
+void DecorationTest::testScales()
+{
+    using KDecoration2::Decoration;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+    QCOMPARE(deco.rect(), QRect(0, 0, 100, 100));
+    QCOMPARE(deco.scales(), QVector<qreal>{1.0});
+
+    // damage is not tracked for scales which never got rendered
+    deco.update(QRect(10, 10, 5, 5));
+    QCOMPARE(bridge.lastUpdate(), QRect(10, 10, 5, 5));
+    QVERIFY(deco.damage(1.0).isEmpty());
+
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    deco.render(&painter, deco.rect(), 1.0);
+    QCOMPARE(deco.paintScales(), QVector<qreal>{1.0});
+    QVERIFY(deco.damage(1.0).isEmpty());
+
+    QSignalSpy scalesChangedSpy(&deco, &Decoration::scalesChanged);
+    QVERIFY(scalesChangedSpy.isValid());
+    QSignalSpy devicePixelRatioChangedSpy(&deco, &Decoration::devicePixelRatioChanged);
+    QVERIFY(devicePixelRatioChangedSpy.isValid());
+
+    // the window spans a second output, only the new scale needs to be rendered completely
+    deco.setScales({1.0, 2.0});
+    QCOMPARE(deco.scales(), QVector<qreal>({2.0, 1.0}));
+    QCOMPARE(deco.devicePixelRatio(), 2.0);
+    QCOMPARE(scalesChangedSpy.count(), 1);
+    QCOMPARE(devicePixelRatioChangedSpy.count(), 1);
+    QVERIFY(deco.damage(2.0).isEmpty());
+    QVERIFY(deco.damage(1.0).isEmpty());
+    QCOMPARE(bridge.lastScaledUpdate(), QRect(0, 0, 200, 200));
+    QCOMPARE(bridge.lastScale(), 2.0);
+    deco.setScales({2.0, 1.0, 2.0});
+    QCOMPARE(scalesChangedSpy.count(), 1);
+    // invalid scales are ignored
+    deco.setScales({});
+    deco.setScales({0.0, -1.0});
+    QCOMPARE(deco.scales(), QVector<qreal>({2.0, 1.0}));
+    QCOMPARE(scalesChangedSpy.count(), 1);
+
+    // damage is tracked for each scale
+    deco.update(QRect(10, 10, 5, 5));
+    QCOMPARE(bridge.lastUpdate(), QRect(10, 10, 5, 5));
+    QCOMPARE(bridge.lastScaledUpdate(), QRect(20, 20, 10, 10));
+    QCOMPARE(deco.damage(1.0), QRegion(10, 10, 5, 5));
+    QVERIFY(deco.damage(2.0).isEmpty());
+
+    QImage hiDpiImage(200, 200, QImage::Format_ARGB32_Premultiplied);
+    hiDpiImage.setDevicePixelRatio(2.0);
+    QPainter hiDpiPainter(&hiDpiImage);
+    deco.render(&hiDpiPainter, deco.rect(), 2.0);
+    QCOMPARE(deco.paintScales(), QVector<qreal>({1.0, 2.0}));
+    QVERIFY(deco.damage(2.0).isEmpty());
+    QCOMPARE(deco.damage(1.0), QRegion(10, 10, 5, 5));
+    QCOMPARE(deco.renderScale(), 2.0);
+
+    deco.update(QRect(1, 1, 1, 1));
+    QCOMPARE(deco.damage(2.0), QRegion(2, 2, 2, 2));
+    deco.render(&painter, QRect(0, 0, 50, 50), 1.0);
+    QCOMPARE(deco.paintScales(), QVector<qreal>({1.0, 2.0, 1.0}));
+    QVERIFY(deco.damage(1.0).isEmpty());
+    QCOMPARE(deco.damage(2.0), QRegion(2, 2, 2, 2));
+
+    // moved completely to a fractional output, partially covered physical pixels stay damaged
+    deco.setScales({1.5});
+    QCOMPARE(deco.scales(), QVector<qreal>{1.5});
+    QCOMPARE(deco.devicePixelRatio(), 1.5);
+    QCOMPARE(devicePixelRatioChangedSpy.count(), 2);
+    QVERIFY(deco.damage(2.0).isEmpty());
+    QVERIFY(deco.damage(1.5).isEmpty());
+    deco.render(&painter, deco.rect(), 1.5);
+    deco.update();
+    QCOMPARE(deco.damage(1.5), QRegion(0, 0, 150, 150));
+    deco.render(&painter, QRect(1, 1, 3, 3), 1.5);
+    QCOMPARE(deco.damage(1.5), QRegion(0, 0, 150, 150).subtracted(QRegion(2, 2, 4, 4)));
+
+    // damage which never gets rendered does not grow without bounds
+    deco.render(&painter, deco.rect(), 1.5);
+    QVERIFY(deco.damage(1.5).isEmpty());
+    for (int i = 0; i < 50; ++i) {
+        deco.update(QRect(i * 2, i * 2, 1, 1));
+    }
+    QVERIFY(deco.damage(1.5).rectCount() <= 16);
+    QCOMPARE(deco.damage(1.5).boundingRect(), QRect(0, 0, 149, 149));
+}
+
+void DecorationTest::testMemoryUsage()
+{
+    using namespace KDecoration2;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    bridge.lastCreatedSettings()->setDecorationButtonsRight(
+        {DecorationButtonType::ContextHelp, DecorationButtonType::Minimize, DecorationButtonType::Maximize, DecorationButtonType::Close});
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(100);
+
+    // a default Decoration needs to stay small for sessions with hundreds of windows
+    DecorationMemoryUsage usage = deco.memoryUsage();
+    QVERIFY(usage.decoration > 0);
+    QVERIFY(usage.decoration < 2048);
+    QVERIFY(usage.damage <= qint64(sizeof(QRect)));
+    QCOMPARE(usage.buttons, qint64(0));
+    QCOMPARE(usage.buttonGroups, qint64(0));
+    QCOMPARE(usage.shadow, qint64(0));
+    QCOMPARE(usage.total(), usage.decoration + usage.damage);
+
+    auto creator = [](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+        return new MockButton(type, decoration, parent);
+    };
+    DecorationButtonGroup group(DecorationButtonGroup::Position::Right, &deco, creator);
+    QCOMPARE(group.buttons().count(), 4);
+    usage = deco.memoryUsage();
+    QVERIFY(usage.buttons > 0);
+    QVERIFY(usage.buttons < 4 * 256);
+    QVERIFY(usage.buttonGroups > 0);
+    QVERIFY(usage.buttonGroups < 512);
+    QVERIFY(usage.decoration < 2048);
+
+    // a shared shadow is counted once in the total
+    auto shadow = QSharedPointer<DecorationShadow>::create();
+    shadow->setShadow(QImage(64, 64, QImage::Format_ARGB32_Premultiplied));
+    deco.setShadow(shadow);
+    MockDecoration deco2(&bridge);
+    deco2.setSettings(decoSettings);
+    deco2.setShadow(shadow);
+    {
+        // destroyed Decorations are not counted
+        MockDecoration deco3(&bridge);
+        deco3.setSettings(decoSettings);
+    }
+    const DecorationMemoryUsage usage1 = deco.memoryUsage();
+    const DecorationMemoryUsage usage2 = deco2.memoryUsage();
+    QVERIFY(usage1.shadow >= 64 * 64 * 4);
+    QCOMPARE(usage2.shadow, usage1.shadow);
+
+    const DecorationMemoryUsage total = Decoration::totalMemoryUsage();
+    QCOMPARE(total.shadow, usage1.shadow);
+    QCOMPARE(total.decoration, usage1.decoration + usage2.decoration);
+    QCOMPARE(total.buttons, usage1.buttons);
+    QCOMPARE(total.total(), usage1.total() + usage2.total() - usage2.shadow);
+}
+
+void DecorationTest::testSettingsChanged()
+{
+    using namespace KDecoration2;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    auto creator = [](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+        return new MockButton(type, decoration, parent);
+    };
+    DecorationButtonGroup left(DecorationButtonGroup::Position::Left, &deco, creator);
+    DecorationButtonGroup right(DecorationButtonGroup::Position::Right, &deco, creator);
+
+    QVector<DecorationSettings::Fields> changes;
+    connect(decoSettings.data(), &DecorationSettings::changed, this, [&changes](DecorationSettings::Fields fields) {
+        changes << fields;
+    });
+    QSignalSpy borderSizeChangedSpy(decoSettings.data(), &DecorationSettings::borderSizeChanged);
+    QVERIFY(borderSizeChangedSpy.isValid());
+
+    // without a batch every change is reported on its own
+    settings->setBorderSize(BorderSize::Large);
+    QCOMPARE(changes.count(), 1);
+    QCOMPARE(changes.last(), DecorationSettings::Fields(DecorationSettings::Field::BorderSize));
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu});
+    QCOMPARE(changes.count(), 2);
+    QCOMPARE(changes.last(), DecorationSettings::Fields(DecorationSettings::Field::DecorationButtonsLeft));
+    QCOMPARE(left.buttons().count(), 1);
+
+    // the units follow the font and are reported with it
+    QFont font = decoSettings->font();
+    font.setPointSizeF(font.pointSizeF() * 2);
+    settings->setFont(font);
+    QCOMPARE(changes.count(), 3);
+    QVERIFY(changes.last().testFlag(DecorationSettings::Field::Font));
+    QVERIFY(!changes.last().testFlag(DecorationSettings::Field::BorderSize));
+
+    // a batch is reported once, the individual signals are still emitted
+    const qint64 layouts = DecorationCounters::snapshot().layouts;
+    settings->beginUpdate();
+    settings->beginUpdate();
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu, DecorationButtonType::OnAllDesktops});
+    settings->setDecorationButtonsRight({DecorationButtonType::Minimize, DecorationButtonType::Close});
+    settings->endUpdate();
+    settings->setBorderSize(BorderSize::Tiny);
+    QCOMPARE(borderSizeChangedSpy.count(), 2);
+    QCOMPARE(changes.count(), 3);
+    // the button groups follow the individual signals, but are laid out once the batch ends
+    QCOMPARE(left.buttons().count(), 2);
+    QCOMPARE(right.buttons().count(), 2);
+    QCOMPARE(DecorationCounters::snapshot().layouts, layouts);
+    settings->endUpdate();
+    QCOMPARE(DecorationCounters::snapshot().layouts, layouts + 2);
+    QCOMPARE(changes.count(), 4);
+    QCOMPARE(changes.last(),
+             DecorationSettings::Field::DecorationButtonsLeft | DecorationSettings::Field::DecorationButtonsRight | DecorationSettings::Field::BorderSize);
+    QCOMPARE(left.buttons().count(), 2);
+    QCOMPARE(right.buttons().count(), 2);
+
+    // an empty batch is not reported
+    settings->beginUpdate();
+    settings->endUpdate();
+    QCOMPARE(changes.count(), 4);
+
+    // can be delivered to other threads
+    QSignalSpy changedSpy(decoSettings.data(), &DecorationSettings::changed);
+    QVERIFY(changedSpy.isValid());
+    DecorationSettings::Fields queued;
+    connect(
+        decoSettings.data(),
+        &DecorationSettings::changed,
+        this,
+        [&queued](DecorationSettings::Fields fields) {
+            queued = fields;
+        },
+        Qt::QueuedConnection);
+    settings->setBorderSize(BorderSize::Huge);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.first().first().value<DecorationSettings::Fields>(), DecorationSettings::Fields(DecorationSettings::Field::BorderSize));
+    QTRY_COMPARE(queued, DecorationSettings::Fields(DecorationSettings::Field::BorderSize));
+}
+
+void DecorationTest::testToolTips()
+{
+    using namespace KDecoration2;
+    class ToolTipDecoration : public MockDecoration
+    {
+    public:
+        using MockDecoration::MockDecoration;
+        using Decoration::setToolTipHideGracePeriod;
+        using Decoration::setToolTipShowDelay;
+    };
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    std::unique_ptr<ToolTipDecoration> deco(new ToolTipDecoration(&bridge));
+    deco->setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    QSignalSpy shownSpy(client, &MockClient::toolTipShown);
+    QVERIFY(shownSpy.isValid());
+    QSignalSpy hiddenSpy(client, &MockClient::toolTipHidden);
+    QVERIFY(hiddenSpy.isValid());
+
+    // by default the requests are debounced
+    QCOMPARE(deco->toolTipShowDelay(), 50);
+    QCOMPARE(deco->toolTipHideGracePeriod(), 50);
+    deco->requestShowToolTip(QStringLiteral("Close"));
+    QCOMPARE(shownSpy.count(), 0);
+    QTRY_COMPARE(shownSpy.count(), 1);
+    // moving on to the next button only updates the text
+    deco->requestHideToolTip();
+    deco->requestShowToolTip(QStringLiteral("Minimize"));
+    QCOMPARE(shownSpy.count(), 2);
+    QCOMPARE(shownSpy.last().first().toString(), QStringLiteral("Minimize"));
+    QCOMPARE(hiddenSpy.count(), 0);
+    deco->requestHideToolTip();
+    QCOMPARE(hiddenSpy.count(), 0);
+    QTRY_COMPARE(hiddenSpy.count(), 1);
+
+    // without delays tooltips follow the requests right away
+    deco->setToolTipShowDelay(0);
+    deco->setToolTipHideGracePeriod(0);
+    QCOMPARE(deco->toolTipShowDelay(), 0);
+    QCOMPARE(deco->toolTipHideGracePeriod(), 0);
+    deco->requestShowToolTip(QStringLiteral("Maximize"));
+    QCOMPARE(shownSpy.count(), 3);
+    deco->requestHideToolTip();
+    QCOMPARE(hiddenSpy.count(), 2);
+
+    // a visible tooltip gets hidden with the Decoration
+    deco->requestShowToolTip(QStringLiteral("Close"));
+    QCOMPARE(shownSpy.count(), 4);
+    deco.reset();
+    QCOMPARE(hiddenSpy.count(), 3);
+}
+
+void DecorationTest::benchmarkCreate()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    QBENCHMARK {
+        MockDecoration deco(&bridge);
+        deco.setSettings(decoSettings);
+        deco.init();
+        createButtons(&deco);
+    }
+}
+
+void DecorationTest::benchmarkRecycle()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    auto deco = new MockDecoration(&bridge);
+    deco->setSettings(decoSettings);
+    deco->init();
+    createButtons(deco);
+    deco->recycle();
+    QObject window;
+    QBENCHMARK {
+        auto recycled = qobject_cast<KDecoration2::Decoration *>(bridge.takeRecycledDecoration());
+        recycled->rebind(&window);
+        recycled->recycle();
+    }
+}
+
 QTEST_MAIN(DecorationTest)
 #include "decorationtest.moc"
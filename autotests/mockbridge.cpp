@@ -25,5 +25,12 @@ std::unique_ptr<KDecoration2::DecorationSettingsPrivate> MockBridge::settings(KD
 void MockBridge::update(KDecoration2::Decoration *decoration, const QRect &geometry)
 {
     Q_UNUSED(decoration)
-    Q_UNUSED(geometry)
+    m_lastUpdate = geometry;
+}
+
+void MockBridge::updateScaled(KDecoration2::Decoration *decoration, const QRect &deviceGeometry, qreal scale)
+{
+    Q_UNUSED(decoration)
+    m_lastScaledUpdate = deviceGeometry;
+    m_lastScale = scale;
 }
@@ -19,6 +19,7 @@ public:
     std::unique_ptr<KDecoration2::DecoratedClientPrivate> createClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration) override;
     std::unique_ptr<KDecoration2::DecorationSettingsPrivate> settings(KDecoration2::DecorationSettings *parent) override;
     void update(KDecoration2::Decoration *decoration, const QRect &geometry) override;
+    void updateScaled(KDecoration2::Decoration *decoration, const QRect &deviceGeometry, qreal scale) override;
 
     MockClient *lastCreatedClient() const
     {
@@ -28,10 +29,25 @@ public:
     {
         return m_lastCreatedSettings;
     }
+    QRect lastUpdate() const
+    {
+        return m_lastUpdate;
+    }
+    QRect lastScaledUpdate() const
+    {
+        return m_lastScaledUpdate;
+    }
+    qreal lastScale() const
+    {
+        return m_lastScale;
+    }
 
 private:
     MockClient *m_lastCreatedClient = nullptr;
     MockSettings *m_lastCreatedSettings = nullptr;
+    QRect m_lastUpdate;
+    QRect m_lastScaledUpdate;
+    qreal m_lastScale = 1.0;
 };
 
 #endif
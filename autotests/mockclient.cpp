@@ -41,7 +41,8 @@ int MockClient::height() const
 
 QIcon MockClient::icon() const
 {
-    return QIcon();
+    m_iconRequests++;
+    return m_icon;
 }
 
 bool MockClient::isActive() const
@@ -121,7 +122,8 @@ bool MockClient::isShaded() const
 
 QPalette MockClient::palette() const
 {
-    return QPalette();
+    m_paletteRequests++;
+    return m_palette;
 }
 
 bool MockClient::hasApplicationMenu() const
@@ -220,11 +222,12 @@ void MockClient::requestToggleShade()
 
 void MockClient::requestShowToolTip(const QString &text)
 {
-    Q_UNUSED(text);
+    emit toolTipShown(text);
 }
 
 void MockClient::requestHideToolTip()
 {
+    emit toolTipHidden();
 }
 
 QSize MockClient::size() const
@@ -242,6 +245,18 @@ WId MockClient::windowId() const
     return 0;
 }
 
+void MockClient::setPalette(const QPalette &palette)
+{
+    m_palette = palette;
+    emit client()->paletteChanged(palette);
+}
+
+void MockClient::setIcon(const QIcon &icon)
+{
+    m_icon = icon;
+    emit client()->iconChanged(icon);
+}
+
 void MockClient::setCloseable(bool set)
 {
     m_closeable = set;
@@ -67,6 +67,16 @@ public:
 
     void setWidth(int w);
     void setHeight(int h);
+    void setPalette(const QPalette &palette);
+    int paletteRequests() const
+    {
+        return m_paletteRequests;
+    }
+    void setIcon(const QIcon &icon);
+    int iconRequests() const
+    {
+        return m_iconRequests;
+    }
 
 Q_SIGNALS:
     void closeRequested();
@@ -74,6 +84,8 @@ Q_SIGNALS:
     void quickHelpRequested();
     void menuRequested();
     void applicationMenuRequested();
+    void toolTipShown(const QString &text);
+    void toolTipHidden();
 
 private:
     bool m_closeable = false;
@@ -89,6 +101,10 @@ private:
     bool m_onAllDesktops = false;
     int m_width = 0;
     int m_height = 0;
+    QPalette m_palette;
+    mutable int m_paletteRequests = 0;
+    QIcon m_icon;
+    mutable int m_iconRequests = 0;
 };
 
 #endif
@@ -35,6 +35,7 @@ void MockDecoration::paint(QPainter *painter, const QRect &repaintRegion)
 {
     Q_UNUSED(painter)
     Q_UNUSED(repaintRegion)
+    m_paintScales << renderScale();
 }
 
 void MockDecoration::setOpaque(bool set)
@@ -22,6 +22,13 @@ public:
     void setBorders(const QMargins &m);
     using Decoration::setTitleBar;
     void setTitleBar(const QRect &rect);
+    QVector<qreal> paintScales() const
+    {
+        return m_paintScales;
+    }
+
+private:
+    QVector<qreal> m_paintScales;
 };
 
 #endif
@@ -13,17 +13,22 @@ MockSettings::MockSettings(KDecoration2::DecorationSettings *parent)
 
 KDecoration2::BorderSize MockSettings::borderSize() const
 {
-    return KDecoration2::BorderSize::Normal;
+    return m_borderSize;
+}
+
+QFont MockSettings::font() const
+{
+    return m_hasFont ? m_font : DecorationSettingsPrivate::font();
 }
 
 QVector<KDecoration2::DecorationButtonType> MockSettings::decorationButtonsLeft() const
 {
-    return QVector<KDecoration2::DecorationButtonType>();
+    return m_buttonsLeft;
 }
 
 QVector<KDecoration2::DecorationButtonType> MockSettings::decorationButtonsRight() const
 {
-    return QVector<KDecoration2::DecorationButtonType>();
+    return m_buttonsRight;
 }
 
 bool MockSettings::isAlphaChannelSupported() const
@@ -58,3 +63,40 @@ void MockSettings::setCloseOnDoubleClickOnMenu(bool set)
     m_closeDoubleClickOnMenu = set;
     emit decorationSettings()->closeOnDoubleClickOnMenuChanged(m_closeDoubleClickOnMenu);
 }
+
+void MockSettings::setDecorationButtonsLeft(const QVector<KDecoration2::DecorationButtonType> &buttons)
+{
+    if (m_buttonsLeft == buttons) {
+        return;
+    }
+    m_buttonsLeft = buttons;
+    emit decorationSettings()->decorationButtonsLeftChanged(m_buttonsLeft);
+}
+
+void MockSettings::setDecorationButtonsRight(const QVector<KDecoration2::DecorationButtonType> &buttons)
+{
+    if (m_buttonsRight == buttons) {
+        return;
+    }
+    m_buttonsRight = buttons;
+    emit decorationSettings()->decorationButtonsRightChanged(m_buttonsRight);
+}
+
+void MockSettings::setBorderSize(KDecoration2::BorderSize size)
+{
+    if (m_borderSize == size) {
+        return;
+    }
+    m_borderSize = size;
+    emit decorationSettings()->borderSizeChanged(m_borderSize);
+}
+
+void MockSettings::setFont(const QFont &font)
+{
+    if (m_hasFont && m_font == font) {
+        return;
+    }
+    m_hasFont = true;
+    m_font = font;
+    emit decorationSettings()->fontChanged(m_font);
+}
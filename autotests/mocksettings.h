@@ -19,13 +19,23 @@ public:
     bool isAlphaChannelSupported() const override;
     bool isCloseOnDoubleClickOnMenu() const override;
     bool isOnAllDesktopsAvailable() const override;
+    QFont font() const override;
 
     void setOnAllDesktopsAvailabe(bool set);
     void setCloseOnDoubleClickOnMenu(bool set);
+    void setDecorationButtonsLeft(const QVector<KDecoration2::DecorationButtonType> &buttons);
+    void setDecorationButtonsRight(const QVector<KDecoration2::DecorationButtonType> &buttons);
+    void setBorderSize(KDecoration2::BorderSize size);
+    void setFont(const QFont &font);
 
 private:
     bool m_onAllDesktopsAvailable = false;
     bool m_closeDoubleClickOnMenu = false;
+    QVector<KDecoration2::DecorationButtonType> m_buttonsLeft;
+    QVector<KDecoration2::DecorationButtonType> m_buttonsRight;
+    KDecoration2::BorderSize m_borderSize = KDecoration2::BorderSize::Normal;
+    bool m_hasFont = false;
+    QFont m_font;
 };
 
 #endif
@@ -0,0 +1,211 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decoratedclient.h"
+#include "../src/decorationrecorder.h"
+#include "../src/decorationreplay.h"
+#include "../src/decorationsettings.h"
+#include "mockbridge.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHoverEvent>
+#include <QPainter>
+#include <QTest>
+
+using namespace KDecoration2;
+
+class TraceDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    using MockDecoration::MockDecoration;
+    void init() override
+    {
+        Decoration::init();
+        auto c = client().toStrongRef();
+        setBorders(QMargins(4, 24, 4, 4));
+        setTitleBar(QRect(0, 0, c->width(), 24));
+        connect(c.data(), &DecoratedClient::widthChanged, this, [this](int width) {
+            setTitleBar(QRect(0, 0, width, 24));
+            update();
+        });
+    }
+    void paint(QPainter *painter, const QRect &repaintArea) override
+    {
+        painter->fillRect(repaintArea, Qt::red);
+    }
+
+    int m_hoverMoves = 0;
+    int m_presses = 0;
+    int m_wheels = 0;
+
+protected:
+    void hoverMoveEvent(QHoverEvent *event) override
+    {
+        m_hoverMoves++;
+        update(QRect(event->pos(), QSize(1, 1)));
+    }
+    void mousePressEvent(QMouseEvent *event) override
+    {
+        m_presses++;
+        event->setAccepted(true);
+    }
+    void wheelEvent(QWheelEvent *event) override
+    {
+        m_wheels++;
+        event->setAccepted(true);
+    }
+};
+
+class RecorderTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testRecordReplay();
+    void testInvalidTrace();
+    void benchmarkReplay();
+};
+
+static void hoverMove(Decoration *deco, const QPointF &pos)
+{
+    QHoverEvent event(QEvent::HoverMove, pos, pos);
+    QCoreApplication::sendEvent(deco, &event);
+}
+
+void RecorderTest::testRecordReplay()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    TraceDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(200);
+    client->setHeight(100);
+    deco.init();
+
+    QBuffer trace;
+    trace.open(QIODevice::WriteOnly);
+    int recordCount = 0;
+    {
+        DecorationRecorder recorder(&deco, &trace);
+        // the complete settings and window state
+        QCOMPARE(recorder.recordCount(), 2);
+
+        QHoverEvent enter(QEvent::HoverEnter, QPointF(10, 10), QPointF());
+        QCoreApplication::sendEvent(&deco, &enter);
+        hoverMove(&deco, QPointF(10, 10));
+        hoverMove(&deco, QPointF(11, 10));
+        client->setWidth(300);
+        QMouseEvent press(QEvent::MouseButtonPress, QPointF(11, 10), Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(&deco, &press);
+        QMouseEvent release(QEvent::MouseButtonRelease, QPointF(11, 10), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(&deco, &release);
+        QWheelEvent wheel(QPointF(11, 10), QPointF(11, 10), QPoint(), QPoint(0, 120), Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false);
+        QCoreApplication::sendEvent(&deco, &wheel);
+        QHoverEvent leave(QEvent::HoverLeave, QPointF(), QPointF(11, 10));
+        QCoreApplication::sendEvent(&deco, &leave);
+        recordCount = recorder.recordCount();
+    }
+    // events after the recorder got destroyed are not recorded
+    const qint64 size = trace.size();
+    hoverMove(&deco, QPointF(12, 10));
+    QCOMPARE(trace.size(), size);
+    trace.close();
+
+    trace.open(QIODevice::ReadOnly);
+    DecorationReplay replay([](QObject *parent, const QVariantList &args) {
+        return new TraceDecoration(parent, args);
+    });
+    QVERIFY(replay.replay(&trace));
+    auto replayed = qobject_cast<TraceDecoration *>(replay.decoration());
+    QVERIFY(replayed);
+    // settings, window state, enter, two moves, width, press, release, wheel and leave
+    QCOMPARE(replay.eventCount(), 10);
+    QCOMPARE(replay.eventCount() + replay.recordedBridgeUpdates(), recordCount);
+    QCOMPARE(replayed->m_hoverMoves, 2);
+    QCOMPARE(replayed->m_presses, 1);
+    QCOMPARE(replayed->m_wheels, 1);
+    auto replayedClient = replayed->client().toStrongRef();
+    QCOMPARE(replayedClient->size(), QSize(300, 100));
+    QCOMPARE(replayed->titleBar(), QRect(0, 0, 300, 24));
+    QCOMPARE(replayed->settings()->borderSize(), decoSettings->borderSize());
+    QCOMPARE(replay.bridgeUpdates(), replay.recordedBridgeUpdates());
+    QVERIFY(replay.bridgeUpdates() > 0);
+    // everything got rendered
+    QVERIFY(replayed->damage(1.0).isEmpty());
+
+    QVERIFY(replay.latency(0) <= replay.latency(50));
+    QVERIFY(replay.latency(50) <= replay.latency(99));
+    QVERIFY(replay.latency(99) <= replay.latency(100));
+}
+
+void RecorderTest::testInvalidTrace()
+{
+    DecorationReplay replay([](QObject *parent, const QVariantList &args) {
+        return new TraceDecoration(parent, args);
+    });
+    QByteArray garbage("not a decoration trace");
+    QBuffer buffer(&garbage);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(!replay.replay(&buffer));
+    QVERIFY(!replay.decoration());
+
+    // a factory which cannot create the Decoration
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    TraceDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    deco.init();
+    QBuffer trace;
+    trace.open(QIODevice::WriteOnly);
+    {
+        DecorationRecorder recorder(&deco, &trace);
+    }
+    trace.close();
+    trace.open(QIODevice::ReadOnly);
+    DecorationReplay failing([](QObject *, const QVariantList &) {
+        return nullptr;
+    });
+    QVERIFY(!failing.replay(&trace));
+}
+
+void RecorderTest::benchmarkReplay()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    TraceDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(1000);
+    client->setHeight(600);
+    deco.init();
+
+    QBuffer trace;
+    trace.open(QIODevice::WriteOnly);
+    {
+        DecorationRecorder recorder(&deco, &trace);
+        for (int i = 0; i < 1000; ++i) {
+            hoverMove(&deco, QPointF(i, 10));
+        }
+    }
+    trace.close();
+    qInfo() << "trace size:" << trace.size() << "bytes";
+
+    trace.open(QIODevice::ReadOnly);
+    DecorationReplay replay([](QObject *parent, const QVariantList &args) {
+        return new TraceDecoration(parent, args);
+    });
+    QVERIFY(replay.replay(&trace));
+    QCOMPARE(replay.eventCount(), 1002);
+    QCOMPARE(replay.bridgeUpdates(), replay.recordedBridgeUpdates());
+    qInfo() << "p50:" << replay.latency(50) << "ns p90:" << replay.latency(90) << "ns p99:" << replay.latency(99) << "ns";
+    qInfo() << "bridge updates:" << replay.bridgeUpdates();
+}
+
+QTEST_MAIN(RecorderTest)
+#include "recordertest.moc"
@@ -0,0 +1,264 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationrenderscheduler.h"
+#include "../src/decorationsettings.h"
+#include "../src/decorationsnapshot.h"
+#include "mockbridge.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using KDecoration2::DecorationRenderScheduler;
+
+class ThreadedDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    explicit ThreadedDecoration(MockBridge *bridge)
+        : MockDecoration(bridge)
+        , m_guiThread(QThread::currentThread())
+    {
+        setSupportsThreadedRendering(true);
+    }
+    void paint(QPainter *painter, const QRect &repaintArea) override
+    {
+        // only the snapshot may be used
+        const KDecoration2::DecorationSnapshot snapshot = renderSnapshot();
+        painter->fillRect(repaintArea, snapshot.palette().color(QPalette::Window));
+        if (QThread::currentThread() != m_guiThread) {
+            m_workerPaints++;
+        }
+        m_paints++;
+    }
+
+    std::atomic<int> m_paints{0};
+    std::atomic<int> m_workerPaints{0};
+
+private:
+    QThread *const m_guiThread;
+};
+
+class RenderSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testGuiThread();
+    void testSnapshot();
+    void testStress();
+};
+
+void RenderSchedulerTest::testGuiThread()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(20);
+    QVERIFY(!deco.supportsThreadedRendering());
+
+    DecorationRenderScheduler scheduler;
+    QSignalSpy renderedSpy(&scheduler, &DecorationRenderScheduler::rendered);
+    QVERIFY(renderedSpy.isValid());
+
+    // painted right away, but delivered from the event loop
+    scheduler.schedule(&deco);
+    QCOMPARE(deco.paintScales(), QVector<qreal>{1.0});
+    QCOMPARE(scheduler.pendingCount(), 1);
+    QVERIFY(renderedSpy.isEmpty());
+    QVERIFY(renderedSpy.wait());
+    QCOMPARE(renderedSpy.count(), 1);
+    QCOMPARE(renderedSpy.first().at(0).value<KDecoration2::Decoration *>(), &deco);
+    QCOMPARE(renderedSpy.first().at(1).toReal(), 1.0);
+    QCOMPARE(renderedSpy.first().at(2).value<QRegion>(), QRegion(0, 0, 100, 20));
+    QCOMPARE(scheduler.pendingCount(), 0);
+    QCOMPARE(scheduler.image(&deco).size(), QSize(100, 20));
+
+    // nothing damaged, nothing to render
+    scheduler.schedule(&deco);
+    QCOMPARE(scheduler.pendingCount(), 0);
+
+    // only the damage gets repainted
+    deco.update(QRect(1, 1, 2, 2));
+    scheduler.schedule(&deco);
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), 2);
+    QCOMPARE(renderedSpy.last().at(2).value<QRegion>(), QRegion(1, 1, 2, 2));
+    QVERIFY(deco.damage(1.0).isEmpty());
+
+    // other scales get their own back-buffer
+    deco.setScales({2.0, 1.0});
+    scheduler.schedule(&deco, 2.0);
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), 3);
+    QCOMPARE(renderedSpy.last().at(2).value<QRegion>(), QRegion(0, 0, 200, 40));
+    QCOMPARE(scheduler.image(&deco, 2.0).size(), QSize(200, 40));
+    QCOMPARE(scheduler.image(&deco, 2.0).devicePixelRatio(), 2.0);
+    QCOMPARE(deco.paintScales(), QVector<qreal>({1.0, 1.0, 2.0}));
+
+    // the two back-buffers of a scale take turns instead of being copied for each render job
+    const uchar *bits = scheduler.image(&deco).constBits();
+    deco.update(QRect(5, 5, 2, 2));
+    scheduler.schedule(&deco);
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), 4);
+    // the older back-buffer also gets the damage of the render job before
+    QCOMPARE(renderedSpy.last().at(2).value<QRegion>(), QRegion(1, 1, 6, 6));
+    QVERIFY(scheduler.image(&deco).constBits() != bits);
+    deco.update(QRect(5, 5, 2, 2));
+    scheduler.schedule(&deco);
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), 5);
+    QCOMPARE(scheduler.image(&deco).constBits(), bits);
+
+    // deleting a scheduled Decoration removes it from the scheduler
+    auto deleted = std::make_unique<MockDecoration>(&bridge);
+    deleted->setSettings(decoSettings);
+    bridge.lastCreatedClient()->setWidth(100);
+    bridge.lastCreatedClient()->setHeight(20);
+    scheduler.schedule(deleted.get());
+    QCOMPARE(scheduler.pendingCount(), 1);
+    deleted.reset();
+    scheduler.waitForDone();
+    QCOMPARE(scheduler.pendingCount(), 0);
+    QCOMPARE(renderedSpy.count(), 5);
+
+    scheduler.remove(&deco);
+    QVERIFY(scheduler.image(&deco).isNull());
+}
+
+void RenderSchedulerTest::testSnapshot()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(100);
+    client->setHeight(20);
+    client->setPalette(QPalette(Qt::black, Qt::red));
+    deco.setBorders(QMargins(1, 2, 3, 4));
+
+    QVERIFY(!KDecoration2::DecorationSnapshot().isValid());
+    const KDecoration2::DecorationSnapshot snapshot(&deco);
+    QVERIFY(snapshot.isValid());
+    QCOMPARE(snapshot.rect(), deco.rect());
+    QCOMPARE(snapshot.borders(), QMargins(1, 2, 3, 4));
+    QCOMPARE(snapshot.palette().color(QPalette::Window), QColor(Qt::red));
+    QCOMPARE(snapshot.buttonCount(), 0);
+
+    // later changes don't affect the snapshot
+    client->setPalette(QPalette(Qt::black, Qt::blue));
+    deco.setBorders(QMargins());
+    QCOMPARE(snapshot.borders(), QMargins(1, 2, 3, 4));
+    QCOMPARE(snapshot.palette().color(QPalette::Window), QColor(Qt::red));
+    QCOMPARE(deco.renderSnapshot().palette().color(QPalette::Window), QColor(Qt::blue));
+}
+
+void RenderSchedulerTest::testStress()
+{
+    // a color scheme change repaints all Decorations at once
+    const int count = 500;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    std::vector<std::unique_ptr<ThreadedDecoration>> decorations;
+    QVector<MockClient *> clients;
+    for (int i = 0; i < count; ++i) {
+        decorations.emplace_back(new ThreadedDecoration(&bridge));
+        decorations.back()->setSettings(decoSettings);
+        MockClient *client = bridge.lastCreatedClient();
+        client->setWidth(100 + i % 50);
+        client->setHeight(30);
+        client->setPalette(QPalette(Qt::black, Qt::red));
+        clients << client;
+    }
+
+    DecorationRenderScheduler scheduler;
+    QSignalSpy renderedSpy(&scheduler, &DecorationRenderScheduler::rendered);
+    QVERIFY(renderedSpy.isValid());
+    for (const auto &deco : decorations) {
+        scheduler.schedule(deco.get());
+    }
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), count);
+    QCOMPARE(scheduler.pendingCount(), 0);
+    for (const auto &deco : decorations) {
+        const QImage image = scheduler.image(deco.get());
+        QCOMPARE(image.size(), deco->size());
+        QCOMPARE(image.pixelColor(0, 0), QColor(Qt::red));
+        QCOMPARE(image.pixelColor(image.width() - 1, image.height() - 1), QColor(Qt::red));
+        QCOMPARE(deco->m_paints.load(), 1);
+        QCOMPARE(deco->m_workerPaints.load(), 1);
+    }
+
+    // half of the Decorations changes again before the first result is delivered,
+    // those get rendered once more with the latest state
+    renderedSpy.clear();
+    for (int i = 0; i < count; ++i) {
+        clients[i]->setPalette(QPalette(Qt::black, Qt::blue));
+        decorations[i]->update();
+        scheduler.schedule(decorations[i].get());
+    }
+    for (int i = 0; i < count; i += 2) {
+        clients[i]->setPalette(QPalette(Qt::black, Qt::green));
+        decorations[i]->update();
+        scheduler.schedule(decorations[i].get());
+    }
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), count + count / 2);
+    for (int i = 0; i < count; ++i) {
+        const QImage image = scheduler.image(decorations[i].get());
+        QCOMPARE(image.pixelColor(0, 0), i % 2 ? QColor(Qt::blue) : QColor(Qt::green));
+        QCOMPARE(decorations[i]->m_paints.load(), i % 2 ? 2 : 3);
+    }
+
+    // Decorations can be removed and deleted while being rendered
+    renderedSpy.clear();
+    for (const auto &deco : decorations) {
+        deco->update();
+        scheduler.schedule(deco.get());
+    }
+    for (int i = 0; i < count; i += 2) {
+        scheduler.remove(decorations[i].get());
+        decorations[i].reset();
+    }
+    // removing only waits for the removed Decoration and does not deliver results
+    QCOMPARE(renderedSpy.count(), 0);
+    scheduler.waitForDone();
+    QCOMPARE(scheduler.pendingCount(), 0);
+    QCOMPARE(renderedSpy.count(), count / 2);
+    for (const QList<QVariant> &arguments : qAsConst(renderedSpy)) {
+        const int index = std::find_if(decorations.cbegin(), decorations.cend(), [&arguments](const std::unique_ptr<ThreadedDecoration> &deco) {
+                              return deco.get() == arguments.first().value<KDecoration2::Decoration *>();
+                          })
+            - decorations.cbegin();
+        QCOMPARE(index % 2, 1);
+    }
+
+    // removed and scheduled again before the result of the removed one got delivered
+    renderedSpy.clear();
+    ThreadedDecoration *deco = decorations[1].get();
+    deco->update();
+    scheduler.schedule(deco);
+    scheduler.remove(deco);
+    deco->update();
+    scheduler.schedule(deco);
+    scheduler.waitForDone();
+    QCOMPARE(renderedSpy.count(), 1);
+    QCOMPARE(scheduler.image(deco).size(), deco->size());
+}
+
+QTEST_MAIN(RenderSchedulerTest)
+#include "renderschedulertest.moc"
@@ -17,6 +17,7 @@ private Q_SLOTS:
     void testPadding();
     void testSizes_data();
     void testSizes();
+    void testIdentity();
 };
 
 void DecorationShadowTest::testPadding_data()
@@ -125,5 +126,60 @@ void DecorationShadowTest::testSizes()
     QCOMPARE(shadow.innerShadowRect(), innerShadowRect.adjusted(1, 1, 1, 1));
 }
 
+void DecorationShadowTest::testIdentity()
+{
+    using namespace KDecoration2;
+    DecorationShadow shadow;
+    DecorationShadow otherShadow;
+    QSignalSpy changedSpy(&shadow, &KDecoration2::DecorationShadow::shadowChanged);
+    QVERIFY(changedSpy.isValid());
+    QVERIFY(shadow.generation() != otherShadow.generation());
+    quint64 generation = shadow.generation();
+
+    QImage image(32, 32, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::black);
+    shadow.setShadow(image);
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(shadow.contentHash(), quint64(0));
+    QVERIFY(shadow.generation() != generation);
+    generation = shadow.generation();
+
+    // the same image, a copy of it and an equal image don't change the shadow
+    shadow.setShadow(image);
+    shadow.setShadow(image.copy());
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(shadow.generation(), generation);
+
+    // with a hash the pixels are not compared
+    QImage white(32, 32, QImage::Format_ARGB32_Premultiplied);
+    white.fill(Qt::white);
+    shadow.setShadow(white, 1);
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(shadow.contentHash(), quint64(1));
+    QVERIFY(shadow.generation() != generation);
+    generation = shadow.generation();
+    shadow.setShadow(image, 1);
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(shadow.shadow().pixel(0, 0), white.pixel(0, 0));
+    shadow.setShadow(image, 2);
+    QCOMPARE(changedSpy.count(), 3);
+    QCOMPARE(shadow.contentHash(), quint64(2));
+    // a different size is a different shadow regardless of the hash
+    shadow.setShadow(QImage(16, 16, QImage::Format_ARGB32_Premultiplied), 2);
+    QCOMPARE(changedSpy.count(), 4);
+    QVERIFY(shadow.generation() != generation);
+    generation = shadow.generation();
+
+    // the geometry is part of the generation
+    shadow.setInnerShadowRect(QRect(4, 4, 8, 8));
+    QVERIFY(shadow.generation() != generation);
+    generation = shadow.generation();
+    shadow.setPadding(QMargins(1, 2, 3, 4));
+    QVERIFY(shadow.generation() != generation);
+    generation = shadow.generation();
+    shadow.setPadding(QMargins(1, 2, 3, 4));
+    QCOMPARE(shadow.generation(), generation);
+}
+
 QTEST_MAIN(DecorationShadowTest)
 #include "shadowtest.moc"
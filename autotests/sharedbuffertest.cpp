@@ -0,0 +1,261 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationsettings.h"
+#include "../src/decorationsharedbuffer.h"
+#include "mockbridge.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QTest>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using KDecoration2::DecorationSharedBuffer;
+
+static const int s_cells = 10;
+static const int s_cellSize = 20;
+
+/**
+ * The color of @p cell after it got changed @p generation times.
+ **/
+static QColor cellColor(int cell, int generation)
+{
+    return QColor::fromHsv((cell * 36 + generation * 7) % 360, 255, 255);
+}
+
+class CellDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    using MockDecoration::MockDecoration;
+    void paint(QPainter *painter, const QRect &repaintArea) override
+    {
+        Q_UNUSED(repaintArea)
+        for (int i = 0; i < s_cells; ++i) {
+            painter->fillRect(QRect(i * s_cellSize, 0, s_cellSize, s_cellSize), cellColor(i, m_generations[i]));
+        }
+    }
+    void change(int cell)
+    {
+        m_generations[cell]++;
+        update(QRect(cell * s_cellSize, 0, s_cellSize, s_cellSize));
+    }
+
+private:
+    int m_generations[s_cells] = {};
+};
+
+class SharedBufferTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFrames();
+    void testUntrustedHandle();
+    void testTwoProcesses();
+};
+
+void SharedBufferTest::testFrames()
+{
+    DecorationSharedBuffer::Frame frame;
+    QVERIFY(!frame.isValid());
+    frame.index = 1;
+    frame.damage = QRegion(0, 0, 10, 10) + QRegion(20, 0, 5, 5);
+    const DecorationSharedBuffer::Frame copy = DecorationSharedBuffer::Frame::fromByteArray(frame.toByteArray());
+    QVERIFY(copy.isValid());
+    QCOMPARE(copy.index, 1);
+    QCOMPARE(copy.damage, frame.damage);
+    QVERIFY(!DecorationSharedBuffer::Frame::fromByteArray(QByteArray()).isValid());
+    frame.index = DecorationSharedBuffer::MaximumCount;
+    QVERIFY(!DecorationSharedBuffer::Frame::fromByteArray(frame.toByteArray()).isValid());
+
+    QVERIFY(!DecorationSharedBuffer::create(QSize()));
+    auto buffer = DecorationSharedBuffer::create(QSize(100, 20), 1.0, 3);
+    QVERIFY(buffer);
+    QCOMPARE(buffer->count(), 3);
+    QCOMPARE(buffer->handle().readyFences.count(), 3);
+    QCOMPARE(buffer->image(2).size(), QSize(100, 20));
+
+    // both sides see the same memory
+    auto other = DecorationSharedBuffer::fromHandle(buffer->handle());
+    QVERIFY(other);
+    QCOMPARE(other->size(), QSize(100, 20));
+    QVERIFY(other->handle().memoryFd != buffer->handle().memoryFd);
+    QCOMPARE(buffer->acquire(0), 0);
+    QCOMPARE(buffer->staleRegion(0), QRegion(0, 0, 100, 20));
+    buffer->image(0).fill(Qt::red);
+    QVERIFY(!other->waitReady(0, 0));
+    buffer->present(0, QRegion(0, 0, 100, 20));
+    QVERIFY(buffer->staleRegion(0).isEmpty());
+    QCOMPARE(buffer->staleRegion(1), QRegion(0, 0, 100, 20));
+    QVERIFY(other->waitReady(0, 0));
+    QCOMPARE(other->image(0).pixelColor(50, 10), QColor(Qt::red));
+
+    // buffers are only handed out again once released
+    QCOMPARE(buffer->acquire(0), 1);
+    QCOMPARE(buffer->acquire(0), 2);
+    QCOMPARE(buffer->acquire(0), -1);
+    QVERIFY(other->release(0));
+    QCOMPARE(buffer->acquire(0), 0);
+
+    // indexes sent by the other process are checked
+    QVERIFY(other->image(3).isNull());
+    QVERIFY(other->image(-1).isNull());
+    QVERIFY(!other->waitReady(3, 0));
+    QVERIFY(!other->release(3));
+
+    // the compositor cannot write to the renderer's buffers
+    QImage copy = other->image(1);
+    copy.fill(Qt::blue);
+    QVERIFY(buffer->image(1).pixelColor(50, 10) != QColor(Qt::blue));
+}
+
+void SharedBufferTest::testUntrustedHandle()
+{
+    auto buffer = DecorationSharedBuffer::create(QSize(100, 20), 1.0, 2);
+    QVERIFY(buffer);
+    DecorationSharedBuffer::Handle handle = buffer->handle();
+    QVERIFY(DecorationSharedBuffer::fromHandle(handle));
+
+    // a memfd that could be truncated while mapped
+    const int unsealed = memfd_create("unsealed", MFD_CLOEXEC);
+    QVERIFY(unsealed >= 0);
+    QCOMPARE(ftruncate(unsealed, 100 * 20 * 4 * 2), 0);
+    handle.memoryFd = unsealed;
+    QVERIFY(!DecorationSharedBuffer::fromHandle(handle));
+    close(unsealed);
+
+    // claims more buffers than the memory holds
+    handle = buffer->handle();
+    handle.size = QSize(100, 40);
+    QVERIFY(!DecorationSharedBuffer::fromHandle(handle));
+
+    // more buffers than allowed
+    handle = buffer->handle();
+    for (int i = handle.readyFences.count(); i <= DecorationSharedBuffer::MaximumCount; ++i) {
+        handle.readyFences << handle.readyFences.first();
+        handle.releaseFences << handle.releaseFences.first();
+    }
+    QVERIFY(!DecorationSharedBuffer::fromHandle(handle));
+}
+
+void SharedBufferTest::testTwoProcesses()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    CellDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(s_cells * s_cellSize);
+    client->setHeight(s_cellSize);
+
+    auto buffer = DecorationSharedBuffer::create(QSize(s_cells * s_cellSize, s_cellSize));
+    QVERIFY(buffer);
+    int sockets[2];
+    QCOMPARE(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets), 0);
+
+    const int frames = 100;
+    const pid_t pid = fork();
+    QVERIFY(pid >= 0);
+    if (pid == 0) {
+        // the compositor, knows the same model as the renderer to verify each frame
+        close(sockets[0]);
+        auto compositor = DecorationSharedBuffer::fromHandle(buffer->handle());
+        int failed = compositor ? 0 : 1;
+        int generations[s_cells] = {};
+        int frameNumber = 0;
+        char data[4096];
+        while (compositor) {
+            const ssize_t size = recv(sockets[1], data, sizeof(data), 0);
+            if (size <= 0) {
+                failed++;
+                break;
+            }
+            const auto frame = DecorationSharedBuffer::Frame::fromByteArray(QByteArray::fromRawData(data, size));
+            if (!frame.isValid()) {
+                break;
+            }
+            // the first frame paints the initial state
+            if (frameNumber > 0) {
+                generations[(frameNumber - 1) % s_cells]++;
+            }
+            frameNumber++;
+            if (!compositor->waitReady(frame.index, 5000)) {
+                failed++;
+                break;
+            }
+            const QImage image = compositor->image(frame.index);
+            for (int i = 0; i < s_cells; ++i) {
+                if (image.pixelColor(i * s_cellSize + s_cellSize / 2, s_cellSize / 2) != cellColor(i, generations[i])) {
+                    failed++;
+                }
+            }
+            compositor->release(frame.index);
+            const char ack = 1;
+            send(sockets[1], &ack, 1, 0);
+        }
+        _exit(failed ? 1 : 0);
+    }
+    close(sockets[1]);
+
+    auto sendFrame = [&](const DecorationSharedBuffer::Frame &frame) {
+        const QByteArray data = frame.toByteArray();
+        return send(sockets[0], data.constData(), data.size(), 0) == data.size();
+    };
+    auto readAck = [&]() {
+        char ack;
+        return recv(sockets[0], &ack, 1, 0) == 1;
+    };
+
+    // pipelined, the renderer blocks in acquire until the compositor released a buffer
+    auto frame = buffer->render(&deco, 5000);
+    QVERIFY(frame.isValid());
+    QCOMPARE(frame.damage, QRegion(0, 0, s_cells * s_cellSize, s_cellSize));
+    QVERIFY(sendFrame(frame));
+    for (int i = 1; i < frames; ++i) {
+        deco.change((i - 1) % s_cells);
+        frame = buffer->render(&deco, 5000);
+        QVERIFY(frame.isValid());
+        if (i > 1) {
+            // only the changed cell and what the buffer missed in the previous frame is repainted
+            int area = 0;
+            for (const QRect &rect : frame.damage) {
+                area += rect.width() * rect.height();
+            }
+            QVERIFY(area <= 2 * s_cellSize * s_cellSize);
+        }
+        QVERIFY(sendFrame(frame));
+    }
+    for (int i = 0; i < frames; ++i) {
+        QVERIFY(readAck());
+    }
+
+    // ping-pong to measure the latency of a frame
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = frames; i < 2 * frames; ++i) {
+        deco.change((i - 1) % s_cells);
+        frame = buffer->render(&deco, 5000);
+        QVERIFY(frame.isValid());
+        QVERIFY(sendFrame(frame));
+        QVERIFY(readAck());
+    }
+    qInfo() << "frame round trip:" << timer.nsecsElapsed() / frames / 1000 << "us";
+
+    QVERIFY(sendFrame(DecorationSharedBuffer::Frame()));
+    int status = 0;
+    QCOMPARE(waitpid(pid, &status, 0), pid);
+    close(sockets[0]);
+    QVERIFY(WIFEXITED(status));
+    QCOMPARE(WEXITSTATUS(status), 0);
+}
+
+QTEST_MAIN(SharedBufferTest)
+#include "sharedbuffertest.moc"
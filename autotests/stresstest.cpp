@@ -0,0 +1,310 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decoratedclient.h"
+#include "../src/decorationbuttongroup.h"
+#include "../src/decorationsettings.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include "mocksettings.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
+using namespace KDecoration2;
+
+/**
+ * A Decoration with the structure of a typical theme: two button groups in the title bar
+ * and borders and title bar following the settings.
+ **/
+class StressDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    using MockDecoration::MockDecoration;
+    void init() override
+    {
+        Decoration::init();
+        auto creator = [](DecorationButtonType type, Decoration *decoration, QObject *parent) -> DecorationButton * {
+            auto button = new MockButton(type, decoration, parent);
+            button->setGeometry(QRectF(0, 0, 20, 20));
+            return button;
+        };
+        m_left = new DecorationButtonGroup(DecorationButtonGroup::Position::Left, this, creator);
+        m_right = new DecorationButtonGroup(DecorationButtonGroup::Position::Right, this, creator);
+        auto s = settings();
+        connect(s.data(), &DecorationSettings::changed, this, [this](DecorationSettings::Fields fields) {
+            const DecorationSettings::Fields layoutFields = DecorationSettings::Field::BorderSize | DecorationSettings::Field::Font
+                | DecorationSettings::Field::DecorationButtonsLeft | DecorationSettings::Field::DecorationButtonsRight;
+            if (fields & layoutFields) {
+                updateLayout();
+            }
+        });
+        auto c = client().toStrongRef();
+        connect(c.data(), &DecoratedClient::widthChanged, this, &StressDecoration::updateLayout);
+        connect(c.data(), &DecoratedClient::paletteChanged, this, [this] {
+            update();
+        });
+        updateLayout();
+    }
+
+    DecorationButtonGroup *leftGroup() const
+    {
+        return m_left;
+    }
+    DecorationButtonGroup *rightGroup() const
+    {
+        return m_right;
+    }
+
+private:
+    void updateLayout()
+    {
+        const int border = settings()->borderSize() == BorderSize::None ? 0 : settings()->smallSpacing() * 2;
+        const int titleBarHeight = qMax(24, int(settings()->fontMetrics().height()) + 8);
+        setBorders(QMargins(border, titleBarHeight, border, border));
+        const int width = client().toStrongRef()->width();
+        setTitleBar(QRect(0, 0, width, titleBarHeight));
+        m_left->setPos(QPointF(border + 4, 2));
+        m_right->setPos(QPointF(width - m_right->geometry().width() - 4, 2));
+        update();
+    }
+
+    DecorationButtonGroup *m_left = nullptr;
+    DecorationButtonGroup *m_right = nullptr;
+};
+
+/**
+ * The costs of all phases of the scenario in nanoseconds.
+ **/
+struct Costs {
+    qint64 create = 0;
+    qint64 buttons = 0;
+    qint64 font = 0;
+    qint64 borderSize = 0;
+    qint64 reconfigure = 0;
+    qint64 palette = 0;
+    qint64 sweep = 0;
+    qint64 destroy = 0;
+
+    qint64 total() const
+    {
+        return create + buttons + font + borderSize + reconfigure + palette + sweep + destroy;
+    }
+};
+
+class StressTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testScaling();
+
+private:
+    Costs run(int windows);
+    /**
+     * Checks that every Decoration follows the settings after the reconfigure phase.
+     **/
+    void verifyLayout(const std::vector<std::unique_ptr<StressDecoration>> &decorations);
+};
+
+void StressTest::verifyLayout(const std::vector<std::unique_ptr<StressDecoration>> &decorations)
+{
+    for (const auto &deco : decorations) {
+        QCOMPARE(deco->leftGroup()->buttons().count(), 2);
+        QCOMPARE(deco->rightGroup()->buttons().count(), 2);
+        const int border = deco->settings()->smallSpacing() * 2;
+        QCOMPARE(deco->borderLeft(), border);
+        QCOMPARE(deco->titleBar().width(), deco->client().toStrongRef()->width());
+        QCOMPARE(deco->leftGroup()->geometry().left(), qreal(border + 4));
+        QCOMPARE(deco->rightGroup()->geometry().right(), qreal(deco->titleBar().width() - 4));
+    }
+}
+
+static qint64 peakRss()
+{
+#ifdef Q_OS_LINUX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // in KiB
+        return qint64(usage.ru_maxrss) * 1024;
+    }
+#endif
+    return -1;
+}
+
+static int budget(const char *name, int defaultValue)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok ? value : defaultValue;
+}
+
+Costs StressTest::run(int windows)
+{
+    Costs costs;
+    QElapsedTimer timer;
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<DecorationSettings>::create(&bridge);
+    MockSettings *settings = bridge.lastCreatedSettings();
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu, DecorationButtonType::OnAllDesktops});
+    settings->setDecorationButtonsRight({DecorationButtonType::ContextHelp,
+                                         DecorationButtonType::Minimize,
+                                         DecorationButtonType::Maximize,
+                                         DecorationButtonType::Close});
+
+    std::vector<std::unique_ptr<StressDecoration>> decorations;
+    std::vector<MockClient *> clients;
+    decorations.reserve(windows);
+    clients.reserve(windows);
+    timer.start();
+    for (int i = 0; i < windows; ++i) {
+        std::unique_ptr<StressDecoration> deco(new StressDecoration(&bridge));
+        MockClient *client = bridge.lastCreatedClient();
+        client->setWidth(400 + i % 800);
+        client->setHeight(300);
+        deco->setSettings(decoSettings);
+        deco->init();
+        decorations.push_back(std::move(deco));
+        clients.push_back(client);
+    }
+    costs.create = timer.nsecsElapsed();
+
+    // every settings change reaches all Decorations at once
+    timer.restart();
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu, DecorationButtonType::KeepAbove, DecorationButtonType::Shade});
+    settings->setDecorationButtonsLeft({DecorationButtonType::Menu, DecorationButtonType::OnAllDesktops});
+    costs.buttons = timer.nsecsElapsed();
+
+    QFont font = decoSettings->font();
+    timer.restart();
+    font.setPointSizeF(font.pointSizeF() * 2);
+    settings->setFont(font);
+    font.setPointSizeF(font.pointSizeF() / 2);
+    settings->setFont(font);
+    costs.font = timer.nsecsElapsed();
+
+    timer.restart();
+    settings->setBorderSize(BorderSize::Large);
+    settings->setBorderSize(BorderSize::None);
+    costs.borderSize = timer.nsecsElapsed();
+
+    // a reconfigure of the backend changes several settings at once
+    timer.restart();
+    settings->beginUpdate();
+    settings->setDecorationButtonsRight({DecorationButtonType::Minimize, DecorationButtonType::Close});
+    settings->setBorderSize(BorderSize::Normal);
+    font.setPointSizeF(font.pointSizeF() * 2);
+    settings->setFont(font);
+    settings->endUpdate();
+    costs.reconfigure = timer.nsecsElapsed();
+    verifyLayout(decorations);
+
+    // e.g. a color scheme change
+    QPalette palette;
+    palette.setColor(QPalette::Window, Qt::darkGray);
+    timer.restart();
+    for (MockClient *client : clients) {
+        client->setPalette(palette);
+    }
+    costs.palette = timer.nsecsElapsed();
+
+    // the pointer crosses the title bar of every window
+    timer.restart();
+    for (const auto &deco : decorations) {
+        const int width = deco->titleBar().width();
+        for (int x = 0; x < width; x += qMax(1, width / 16)) {
+            const QPointF pos(x, 10);
+            QHoverEvent move(QEvent::HoverMove, pos, pos);
+            QCoreApplication::sendEvent(deco.get(), &move);
+        }
+        QHoverEvent leave(QEvent::HoverLeave, QPointF(), QPointF(width, 10));
+        QCoreApplication::sendEvent(deco.get(), &leave);
+    }
+    costs.sweep = timer.nsecsElapsed();
+
+    timer.restart();
+    decorations.clear();
+    costs.destroy = timer.nsecsElapsed();
+    return costs;
+}
+
+void StressTest::testScaling()
+{
+    // absolute timing and memory depend on the build and the machine, e.g. sanitizers or a
+    // loaded CI, so by default only the functional checks and the scaling ratio of each phase
+    // run with a small number of windows
+    const bool checkBudgets = qEnvironmentVariableIntValue("KDECORATION2_STRESS_BUDGETS") != 0;
+    const int windows = budget("KDECORATION2_STRESS_WINDOWS", checkBudgets ? 2000 : 200);
+    const int perWindowBudget = budget("KDECORATION2_STRESS_WINDOW_BUDGET_US", 2000);
+    const int totalBudget = budget("KDECORATION2_STRESS_TOTAL_BUDGET_MS", 60000);
+    const int rssBudget = budget("KDECORATION2_STRESS_RSS_BUDGET_MB", 1024);
+
+    QElapsedTimer timer;
+    timer.start();
+    const Costs small = run(windows / 4);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    const Costs large = run(windows);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    const qint64 elapsed = timer.elapsed();
+    const qint64 rss = peakRss();
+
+    auto perWindow = [](qint64 cost, int count) {
+        return cost / qMax(1, count);
+    };
+    const struct {
+        const char *name;
+        qint64 small;
+        qint64 large;
+    } phases[] = {
+        {"create", small.create, large.create},
+        {"buttons", small.buttons, large.buttons},
+        {"font", small.font, large.font},
+        {"borderSize", small.borderSize, large.borderSize},
+        {"reconfigure", small.reconfigure, large.reconfigure},
+        {"palette", small.palette, large.palette},
+        {"sweep", small.sweep, large.sweep},
+        {"destroy", small.destroy, large.destroy},
+    };
+    for (const auto &phase : phases) {
+        const qint64 smallCost = perWindow(phase.small, windows / 4);
+        const qint64 largeCost = perWindow(phase.large, windows);
+        qInfo() << phase.name << "per window:" << largeCost / 1000.0 << "us at" << windows << "windows," << smallCost / 1000.0 << "us at" << windows / 4;
+        // the per window cost stays flat with linear behavior, it quadruples with quadratic
+        // behavior; small costs are dominated by noise
+        QVERIFY2(largeCost <= 3 * qMax<qint64>(smallCost, 5000), phase.name);
+        if (checkBudgets) {
+            QVERIFY2(largeCost / 1000 <= perWindowBudget, phase.name);
+        }
+    }
+    qInfo() << "total:" << elapsed << "ms, per window:" << perWindow(large.total(), windows) / 1000.0 << "us";
+    if (rss >= 0) {
+        qInfo() << "peak RSS:" << rss / (1024 * 1024) << "MiB";
+    }
+    if (!checkBudgets) {
+        return;
+    }
+    QVERIFY(elapsed <= totalBudget);
+    if (rss >= 0) {
+        QVERIFY(rss / (1024 * 1024) <= rssBudget);
+    }
+}
+
+QTEST_MAIN(StressTest)
+#include "stresstest.moc"
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationsettings.h"
+#include "../src/decorationtilebuffer.h"
+#include "mockbridge.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QDebug>
+#include <QPainter>
+#include <QTest>
+
+using KDecoration2::DecorationTileBuffer;
+
+class FillDecoration : public MockDecoration
+{
+    Q_OBJECT
+public:
+    using MockDecoration::MockDecoration;
+    void paint(QPainter *painter, const QRect &repaintArea) override
+    {
+        painter->fillRect(rect(), Qt::red);
+        m_repaintAreas << repaintArea;
+    }
+
+    QVector<QRect> m_repaintAreas;
+};
+
+class TileBufferTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTiles();
+    void testScale();
+    void benchmarkHover_data();
+    void benchmarkHover();
+};
+
+void TileBufferTest::testTiles()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    FillDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(1000);
+    client->setHeight(30);
+
+    DecorationTileBuffer buffer(&deco, 1.0, QSize(256, 256));
+    QCOMPARE(buffer.tileCount(), 0);
+    // everything gets painted initially
+    QCOMPARE(buffer.render(), QVector<int>({0, 1, 2, 3}));
+    QCOMPARE(buffer.size(), QSize(1000, 30));
+    QCOMPARE(buffer.tileCount(), 4);
+    QCOMPARE(buffer.tileRect(1), QRect(256, 0, 256, 30));
+    QCOMPARE(buffer.tileRect(3), QRect(768, 0, 232, 30));
+    QCOMPARE(buffer.tile(3).size(), QSize(232, 30));
+    QCOMPARE(buffer.repaintedBytes(), qint64(1000 * 30 * 4));
+    QCOMPARE(deco.m_repaintAreas.at(1), QRect(256, 0, 256, 30));
+    // painted in Decoration coordinates, translated into the tile
+    QCOMPARE(buffer.tile(1).pixelColor(0, 0), QColor(Qt::red));
+    QCOMPARE(buffer.tile(3).pixelColor(231, 29), QColor(Qt::red));
+
+    // nothing damaged, nothing painted
+    deco.m_repaintAreas.clear();
+    QVERIFY(buffer.render().isEmpty());
+    QCOMPARE(buffer.repaintedBytes(), qint64(0));
+    QVERIFY(deco.m_repaintAreas.isEmpty());
+
+    // only tiles touched by the damage get repainted
+    deco.update(QRect(300, 5, 10, 10));
+    QCOMPARE(buffer.render(), QVector<int>{1});
+    QCOMPARE(buffer.repaintedBytes(), qint64(256 * 30 * 4));
+    deco.update(QRect(500, 0, 20, 10));
+    deco.update(QRect(990, 0, 10, 10));
+    QCOMPARE(buffer.render(), QVector<int>({1, 2, 3}));
+    QVERIFY(!buffer.isDirty(0));
+    // damage outside of the Decoration is ignored
+    deco.update(QRect(2000, 0, 10, 10));
+    QVERIFY(buffer.render().isEmpty());
+
+    // a new size repaints everything
+    client->setWidth(1200);
+    QCOMPARE(buffer.render(), QVector<int>({0, 1, 2, 3, 4}));
+}
+
+void TileBufferTest::testScale()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    FillDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(200);
+    client->setHeight(20);
+    deco.setScales({1.5});
+
+    DecorationTileBuffer buffer(&deco, 1.5, QSize(64, 64));
+    QCOMPARE(buffer.render().count(), 5);
+    QCOMPARE(buffer.size(), QSize(300, 30));
+    QCOMPARE(buffer.tile(1).devicePixelRatio(), 1.5);
+    // the logical repaint area covers the tile's physical pixels
+    QCOMPARE(deco.m_repaintAreas.at(1), QRect(42, 0, 44, 20));
+    QCOMPARE(buffer.tile(1).pixelColor(0, 0), QColor(Qt::red));
+
+    // damage is tracked in physical pixels
+    deco.update(QRect(43, 0, 1, 1));
+    QCOMPARE(buffer.render(), QVector<int>{1});
+    deco.update(QRect(42, 0, 1, 1));
+    QCOMPARE(buffer.render(), QVector<int>({0, 1}));
+}
+
+void TileBufferTest::benchmarkHover_data()
+{
+    QTest::addColumn<QSize>("tileSize");
+
+    QTest::newRow("64") << QSize(64, 64);
+    QTest::newRow("256") << QSize(256, 256);
+    QTest::newRow("untiled") << QSize(7680, 256);
+}
+
+void TileBufferTest::benchmarkHover()
+{
+    // the title bar of a maximized window on an 8K output
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    FillDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(7680);
+    client->setHeight(32);
+
+    QFETCH(QSize, tileSize);
+    DecorationTileBuffer buffer(&deco, 1.0, tileSize);
+    buffer.render();
+
+    // a close button in the top right corner changes its hover state
+    const QRect button(7650, 4, 24, 24);
+    qint64 bytes = 0;
+    int hovers = 0;
+    QBENCHMARK {
+        deco.update(button);
+        buffer.render();
+        bytes += buffer.repaintedBytes();
+        hovers++;
+    }
+    qInfo() << "bytes repainted per hover:" << bytes / hovers;
+}
+
+QTEST_MAIN(TileBufferTest)
+#include "tilebuffertest.moc"
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationtimerservice_p.h"
+#include <QTest>
+
+using KDecoration2::DecorationTimerService;
+
+class TimerServiceTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testExpire();
+    void testCancelWhileExpiring();
+};
+
+void TimerServiceTest::testExpire()
+{
+    DecorationTimerService timers;
+    int first = 0;
+    int second = 0;
+    const int a = 0;
+    const int b = 0;
+    timers.schedule(&a, 0, [&first] {
+        first++;
+    });
+    timers.schedule(&b, 10, [&second] {
+        second++;
+    });
+    QCOMPARE(timers.count(), 2);
+    QVERIFY(timers.isScheduled(&a));
+    // scheduling again replaces the deadline
+    timers.schedule(&a, 0, [&first] {
+        first += 10;
+    });
+    QCOMPARE(timers.count(), 2);
+    QTRY_COMPARE(second, 1);
+    QCOMPARE(first, 10);
+    QCOMPARE(timers.count(), 0);
+}
+
+void TimerServiceTest::testCancelWhileExpiring()
+{
+    // the callback of one owner deletes another owner which expires at the same time
+    DecorationTimerService timers;
+    const int a = 0;
+    const int b = 0;
+    int invoked = 0;
+    timers.schedule(&a, 0, [&] {
+        invoked++;
+        timers.cancel(&b);
+    });
+    timers.schedule(&b, 0, [&invoked] {
+        invoked += 10;
+    });
+    QTest::qWait(20);
+    QCOMPARE(invoked, 1);
+    QCOMPARE(timers.count(), 0);
+}
+
+QTEST_MAIN(TimerServiceTest)
+#include "timerservicetest.moc"
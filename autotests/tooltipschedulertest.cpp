@@ -0,0 +1,319 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationtooltipscheduler_p.h"
+#include <QTest>
+
+using KDecoration2::DecorationToolTipScheduler;
+
+class ToolTipSchedulerTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void testDefaults();
+    void testShowImmediately();
+    void testShowDelay();
+    void testCancelPendingShow();
+    void testHideGracePeriod();
+    void testWarmMove();
+    void testSameText();
+    void testWarmPeriod();
+    void testReset();
+    void testSweep();
+
+private:
+    void setupScheduler(DecorationToolTipScheduler &scheduler);
+    qint64 m_now = 0;
+    QStringList m_shown;
+    int m_hidden = 0;
+    QList<int> m_wakeUps;
+};
+
+void ToolTipSchedulerTest::init()
+{
+    m_now = 1000;
+    m_shown.clear();
+    m_hidden = 0;
+    m_wakeUps.clear();
+}
+
+void ToolTipSchedulerTest::setupScheduler(DecorationToolTipScheduler &scheduler)
+{
+    scheduler.setShowCallback([this](const QString &text) {
+        m_shown << text;
+    });
+    scheduler.setHideCallback([this] {
+        m_hidden++;
+    });
+    scheduler.setWakeUpCallback([this](int msec) {
+        m_wakeUps << msec;
+    });
+}
+
+void ToolTipSchedulerTest::testDefaults()
+{
+    // by default a quick pass over a button shows nothing and hiding waits for the next one
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    QCOMPARE(scheduler.showDelay(), 50);
+    QCOMPARE(scheduler.hideGracePeriod(), 50);
+
+    scheduler.show(QStringLiteral("Close"));
+    m_now += 20;
+    scheduler.hide();
+    QVERIFY(m_shown.isEmpty());
+    QCOMPARE(m_hidden, 0);
+
+    scheduler.show(QStringLiteral("Minimize"));
+    m_now += 50;
+    scheduler.advance();
+    QCOMPARE(m_shown, QStringList{QStringLiteral("Minimize")});
+    scheduler.hide();
+    QCOMPARE(m_hidden, 0);
+    m_now += 50;
+    scheduler.advance();
+    QCOMPARE(m_hidden, 1);
+}
+
+void ToolTipSchedulerTest::testShowImmediately()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(0);
+    QVERIFY(!scheduler.isVisible());
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+
+    scheduler.show(QStringLiteral("Close"));
+    QCOMPARE(m_shown, QStringList{QStringLiteral("Close")});
+    QVERIFY(scheduler.isVisible());
+    QCOMPARE(scheduler.text(), QStringLiteral("Close"));
+    QVERIFY(m_wakeUps.isEmpty());
+}
+
+void ToolTipSchedulerTest::testShowDelay()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(500);
+
+    scheduler.show(QStringLiteral("Close"));
+    QVERIFY(m_shown.isEmpty());
+    QVERIFY(!scheduler.isVisible());
+    QCOMPARE(m_wakeUps, QList<int>{500});
+    QCOMPARE(scheduler.deadline(), qint64(1500));
+
+    // the text changes while waiting, the deadline does not
+    m_now += 200;
+    scheduler.show(QStringLiteral("Minimize"));
+    QCOMPARE(scheduler.deadline(), qint64(1500));
+
+    // waking up early asks for another wake up
+    m_now += 299;
+    scheduler.advance();
+    QVERIFY(m_shown.isEmpty());
+    QCOMPARE(m_wakeUps, QList<int>({500, 1}));
+
+    m_now += 1;
+    scheduler.advance();
+    QCOMPARE(m_shown, QStringList{QStringLiteral("Minimize")});
+    QVERIFY(scheduler.isVisible());
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+}
+
+void ToolTipSchedulerTest::testCancelPendingShow()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(500);
+
+    scheduler.show(QStringLiteral("Close"));
+    m_now += 100;
+    scheduler.hide();
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+    m_now += 1000;
+    scheduler.advance();
+    // nothing was shown, so nothing gets hidden
+    QVERIFY(m_shown.isEmpty());
+    QCOMPARE(m_hidden, 0);
+}
+
+void ToolTipSchedulerTest::testHideGracePeriod()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(0);
+    scheduler.setHideGracePeriod(100);
+
+    scheduler.show(QStringLiteral("Close"));
+    scheduler.hide();
+    QCOMPARE(m_hidden, 0);
+    QVERIFY(scheduler.isVisible());
+    QCOMPARE(m_wakeUps, QList<int>{100});
+
+    // hiding again does not extend the grace period
+    m_now += 50;
+    scheduler.hide();
+    QCOMPARE(scheduler.deadline(), qint64(1100));
+
+    m_now += 50;
+    scheduler.advance();
+    QCOMPARE(m_hidden, 1);
+    QVERIFY(!scheduler.isVisible());
+    QVERIFY(scheduler.text().isEmpty());
+
+    // without grace period the tooltip is hidden right away
+    scheduler.setHideGracePeriod(0);
+    scheduler.show(QStringLiteral("Close"));
+    scheduler.hide();
+    QCOMPARE(m_hidden, 2);
+}
+
+void ToolTipSchedulerTest::testWarmMove()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(0);
+    scheduler.setHideGracePeriod(100);
+
+    scheduler.show(QStringLiteral("Minimize"));
+    m_now += 10;
+    scheduler.hide();
+    m_now += 10;
+    // moving to the next button only updates the text
+    scheduler.show(QStringLiteral("Maximize"));
+    QCOMPARE(m_shown, QStringList({QStringLiteral("Minimize"), QStringLiteral("Maximize")}));
+    QCOMPARE(m_hidden, 0);
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+
+    // the cancelled hide does not fire later on
+    m_now += 1000;
+    scheduler.advance();
+    QCOMPARE(m_hidden, 0);
+    QVERIFY(scheduler.isVisible());
+}
+
+void ToolTipSchedulerTest::testSameText()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(0);
+    scheduler.setHideGracePeriod(100);
+
+    scheduler.show(QStringLiteral("Close"));
+    scheduler.show(QStringLiteral("Close"));
+    scheduler.hide();
+    scheduler.show(QStringLiteral("Close"));
+    QCOMPARE(m_shown, QStringList{QStringLiteral("Close")});
+    QCOMPARE(m_hidden, 0);
+}
+
+void ToolTipSchedulerTest::testWarmPeriod()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(300);
+    scheduler.setHideGracePeriod(0);
+    scheduler.setWarmPeriod(500);
+
+    scheduler.show(QStringLiteral("Close"));
+    m_now += 300;
+    scheduler.advance();
+    QCOMPARE(m_shown.count(), 1);
+    scheduler.hide();
+    QCOMPARE(m_hidden, 1);
+
+    // within the warm period the delay is skipped
+    m_now += 499;
+    scheduler.show(QStringLiteral("Shade"));
+    QCOMPARE(m_shown.count(), 2);
+    QCOMPARE(m_shown.last(), QStringLiteral("Shade"));
+    scheduler.hide();
+
+    // afterwards the delay applies again
+    m_now += 500;
+    scheduler.show(QStringLiteral("Menu"));
+    QCOMPARE(m_shown.count(), 2);
+    QCOMPARE(scheduler.deadline(), m_now + 300);
+}
+
+void ToolTipSchedulerTest::testReset()
+{
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(300);
+    scheduler.setHideGracePeriod(100);
+
+    // resetting a pending show does not hide anything
+    scheduler.show(QStringLiteral("Close"));
+    scheduler.reset();
+    QCOMPARE(m_hidden, 0);
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+
+    // a visible tooltip with a pending hide gets hidden immediately
+    scheduler.show(QStringLiteral("Close"));
+    m_now += 300;
+    scheduler.advance();
+    scheduler.hide();
+    scheduler.reset();
+    QCOMPARE(m_hidden, 1);
+    QVERIFY(!scheduler.isVisible());
+    QCOMPARE(scheduler.deadline(), qint64(-1));
+
+    // the reset also ends the warm period
+    scheduler.show(QStringLiteral("Close"));
+    QCOMPARE(m_shown.count(), 1);
+}
+
+void ToolTipSchedulerTest::testSweep()
+{
+    // moving across a row of buttons results in one show per button and a single hide
+    DecorationToolTipScheduler scheduler([this] {
+        return m_now;
+    });
+    setupScheduler(scheduler);
+    scheduler.setShowDelay(0);
+    scheduler.setHideGracePeriod(100);
+
+    const QStringList texts{QStringLiteral("Menu"),
+                            QStringLiteral("On all desktops"),
+                            QStringLiteral("Minimize"),
+                            QStringLiteral("Maximize"),
+                            QStringLiteral("Close")};
+    for (const QString &text : texts) {
+        scheduler.show(text);
+        m_now += 40;
+        scheduler.advance();
+        scheduler.hide();
+        m_now += 5;
+        scheduler.advance();
+    }
+    QCOMPARE(m_shown, texts);
+    QCOMPARE(m_hidden, 0);
+    m_now += 100;
+    scheduler.advance();
+    QCOMPARE(m_hidden, 1);
+}
+
+QTEST_GUILESS_MAIN(ToolTipSchedulerTest)
+#include "tooltipschedulertest.moc"
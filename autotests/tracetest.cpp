@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "../src/decorationsettings.h"
+#include "../src/decorationtrace.h"
+#include "mockbridge.h"
+#include "mockbutton.h"
+#include "mockclient.h"
+#include "mockdecoration.h"
+#include <QCoreApplication>
+#include <QHoverEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTest>
+
+using KDecoration2::DecorationTrace;
+
+class TraceTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testChromeTrace();
+    void benchmarkHover();
+};
+
+static void hoverMove(KDecoration2::Decoration *deco, const QPointF &pos)
+{
+    QHoverEvent event(QEvent::HoverMove, pos, pos);
+    QCoreApplication::sendEvent(deco, &event);
+}
+
+void TraceTest::testChromeTrace()
+{
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(200);
+    client->setHeight(100);
+    deco.setBorders(QMargins(4, 24, 4, 4));
+    deco.setTitleBar(QRect(0, 0, 200, 24));
+    MockButton button(KDecoration2::DecorationButtonType::Custom, &deco);
+    button.setGeometry(QRectF(10, 4, 16, 16));
+
+    DecorationTrace::clear();
+    QCOMPARE(DecorationTrace::eventCount(), 0);
+    hoverMove(&deco, QPointF(12, 8));
+    hoverMove(&deco, QPointF(100, 8));
+    deco.update();
+
+    const QJsonDocument document = QJsonDocument::fromJson(DecorationTrace::toChromeTrace());
+    QVERIFY(document.isObject());
+    const QJsonArray events = document.object().value(QStringLiteral("traceEvents")).toArray();
+    QCOMPARE(events.count(), DecorationTrace::eventCount());
+    if (!DecorationTrace::isEnabled()) {
+        QVERIFY(events.isEmpty());
+        return;
+    }
+
+    QSet<QString> names;
+    for (const auto &value : events) {
+        const QJsonObject event = value.toObject();
+        QCOMPARE(event.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+        QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 0.0);
+        QVERIFY(event.value(QStringLiteral("ts")).toDouble() > 0.0);
+        names << event.value(QStringLiteral("name")).toString();
+    }
+    QVERIFY(names.contains(QStringLiteral("Decoration::event")));
+    QVERIFY(names.contains(QStringLiteral("Decoration::updateSectionUnderMouse")));
+    QVERIFY(names.contains(QStringLiteral("DecorationButton::event")));
+    QVERIFY(names.contains(QStringLiteral("Decoration::update")));
+    QVERIFY(names.contains(QStringLiteral("DecorationBridge::update")));
+
+    DecorationTrace::clear();
+    QCOMPARE(DecorationTrace::eventCount(), 0);
+}
+
+void TraceTest::benchmarkHover()
+{
+    // compare with a build without KDECORATION2_TRACING for the overhead of the scopes
+    MockBridge bridge;
+    auto decoSettings = QSharedPointer<KDecoration2::DecorationSettings>::create(&bridge);
+    MockDecoration deco(&bridge);
+    deco.setSettings(decoSettings);
+    MockClient *client = bridge.lastCreatedClient();
+    client->setWidth(200);
+    client->setHeight(100);
+    deco.setTitleBar(QRect(0, 0, 200, 24));
+    MockButton button(KDecoration2::DecorationButtonType::Custom, &deco);
+    button.setGeometry(QRectF(10, 4, 16, 16));
+
+    int x = 0;
+    QBENCHMARK {
+        hoverMove(&deco, QPointF(x++ % 200, 8));
+    }
+}
+
+QTEST_MAIN(TraceTest)
+#include "tracetest.moc"
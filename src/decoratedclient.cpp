@@ -12,14 +12,216 @@
 
 namespace KDecoration2
 {
+namespace
+{
+/**
+ * Backend used while a recycled Decoration waits in the DecorationBridge's pool.
+ * The window it decorated is gone, so it only provides default values.
+ **/
+class DetachedClientPrivate : public DecoratedClientPrivate
+{
+public:
+    explicit DetachedClientPrivate(DecoratedClient *client, Decoration *decoration)
+        : DecoratedClientPrivate(client, decoration)
+    {
+    }
+    bool isActive() const override
+    {
+        return false;
+    }
+    QString caption() const override
+    {
+        return QString();
+    }
+    int desktop() const override
+    {
+        return 0;
+    }
+    bool isOnAllDesktops() const override
+    {
+        return false;
+    }
+    bool isShaded() const override
+    {
+        return false;
+    }
+    QIcon icon() const override
+    {
+        return QIcon();
+    }
+    bool isMaximized() const override
+    {
+        return false;
+    }
+    bool isMaximizedHorizontally() const override
+    {
+        return false;
+    }
+    bool isMaximizedVertically() const override
+    {
+        return false;
+    }
+    bool isKeepAbove() const override
+    {
+        return false;
+    }
+    bool isKeepBelow() const override
+    {
+        return false;
+    }
+    bool isCloseable() const override
+    {
+        return false;
+    }
+    bool isMaximizeable() const override
+    {
+        return false;
+    }
+    bool isMinimizeable() const override
+    {
+        return false;
+    }
+    bool providesContextHelp() const override
+    {
+        return false;
+    }
+    bool isModal() const override
+    {
+        return false;
+    }
+    bool isShadeable() const override
+    {
+        return false;
+    }
+    bool isMoveable() const override
+    {
+        return false;
+    }
+    bool isResizeable() const override
+    {
+        return false;
+    }
+    WId windowId() const override
+    {
+        return 0;
+    }
+    WId decorationId() const override
+    {
+        return 0;
+    }
+    int width() const override
+    {
+        return 0;
+    }
+    int height() const override
+    {
+        return 0;
+    }
+    QSize size() const override
+    {
+        return QSize();
+    }
+    QPalette palette() const override
+    {
+        return QPalette();
+    }
+    Qt::Edges adjacentScreenEdges() const override
+    {
+        return Qt::Edges();
+    }
+    void requestShowToolTip(const QString &text) override
+    {
+        Q_UNUSED(text)
+    }
+    void requestHideToolTip() override
+    {
+    }
+    void requestClose() override
+    {
+    }
+    void requestToggleMaximization(Qt::MouseButtons buttons) override
+    {
+        Q_UNUSED(buttons)
+    }
+    void requestMinimize() override
+    {
+    }
+    void requestContextHelp() override
+    {
+    }
+    void requestToggleOnAllDesktops() override
+    {
+    }
+    void requestToggleShade() override
+    {
+    }
+    void requestToggleKeepAbove() override
+    {
+    }
+    void requestToggleKeepBelow() override
+    {
+    }
+    void requestShowWindowMenu(const QRect &rect) override
+    {
+        Q_UNUSED(rect)
+    }
+};
+}
+
 DecoratedClient::DecoratedClient(Decoration *parent, DecorationBridge *bridge)
     : QObject()
     , d(std::move(bridge->createClient(this, parent)))
 {
+    // connected first, so that colors are up to date for everyone else listening
+    connect(this, &DecoratedClient::paletteChanged, this, [this] {
+        d->invalidateColorCache();
+    });
+    connect(this, &DecoratedClient::iconChanged, this, [this] {
+        d->invalidateIconCache();
+    });
 }
 
 DecoratedClient::~DecoratedClient() = default;
 
+void DecoratedClient::detach()
+{
+    d.reset(new DetachedClientPrivate(this, d->decoration()));
+}
+
+void DecoratedClient::rebind(DecorationBridge *bridge)
+{
+    d = bridge->createClient(this, d->decoration());
+
+    emit activeChanged(isActive());
+    emit captionChanged(caption());
+    emit desktopChanged(desktop());
+    emit onAllDesktopsChanged(isOnAllDesktops());
+    emit shadedChanged(isShaded());
+    emit iconChanged(icon());
+    emit maximizedChanged(isMaximized());
+    emit maximizedHorizontallyChanged(isMaximizedHorizontally());
+    emit maximizedVerticallyChanged(isMaximizedVertically());
+    emit keepAboveChanged(isKeepAbove());
+    emit keepBelowChanged(isKeepBelow());
+
+    emit closeableChanged(isCloseable());
+    emit maximizeableChanged(isMaximizeable());
+    emit minimizeableChanged(isMinimizeable());
+    emit providesContextHelpChanged(providesContextHelp());
+    emit shadeableChanged(isShadeable());
+    emit moveableChanged(isMoveable());
+    emit resizeableChanged(isResizeable());
+
+    emit widthChanged(width());
+    emit heightChanged(height());
+    emit sizeChanged(size());
+    emit paletteChanged(palette());
+    emit adjacentScreenEdgesChanged(adjacentScreenEdges());
+
+    emit hasApplicationMenuChanged(hasApplicationMenu());
+    emit applicationMenuActiveChanged(isApplicationMenuActive());
+}
+
 #define DELEGATE(type, method)                                                                                                                                 \
     type DecoratedClient::method() const                                                                                                                       \
     {                                                                                                                                                          \
@@ -78,12 +280,17 @@ QPointer<Decoration> DecoratedClient::decoration() const
 
 QColor DecoratedClient::color(QPalette::ColorGroup group, QPalette::ColorRole role) const
 {
-    return d->palette().color(group, role);
+    return d->cachedColor(group, role);
 }
 
 QColor DecoratedClient::color(ColorGroup group, ColorRole role) const
 {
-    return d->color(group, role);
+    return d->cachedColor(group, role);
+}
+
+QPixmap DecoratedClient::iconPixmap(const QSize &size, qreal devicePixelRatio, QIcon::Mode mode, QIcon::State state) const
+{
+    return d->cachedIconPixmap(size, devicePixelRatio, mode, state);
 }
 
 void DecoratedClient::showApplicationMenu(int actionId)
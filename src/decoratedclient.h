@@ -179,6 +179,13 @@ public:
     bool isOnAllDesktops() const;
     bool isShaded() const;
     QIcon icon() const;
+    /**
+     * The icon rendered as a pixmap of @p size logical pixels for the given @p devicePixelRatio.
+     * The pixmaps are cached, so that painting the icon does not need to render it each time.
+     * @see icon
+     * @since 5.22
+     **/
+    QPixmap iconPixmap(const QSize &size, qreal devicePixelRatio, QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off) const;
     bool isMaximized() const;
     bool isMaximizedHorizontally() const;
     bool isMaximizedVertically() const;
@@ -273,7 +280,15 @@ Q_SIGNALS:
 private:
     friend class Decoration;
     DecoratedClient(Decoration *parent, DecorationBridge *bridge);
-    const std::unique_ptr<DecoratedClientPrivate> d;
+    /**
+     * Releases the backend, afterwards the DecoratedClient reports default values.
+     **/
+    void detach();
+    /**
+     * Binds to a new backend created by @p bridge and emits all change signals.
+     **/
+    void rebind(DecorationBridge *bridge);
+    std::unique_ptr<DecoratedClientPrivate> d;
 };
 
 } // namespace
@@ -7,12 +7,24 @@
 #include "decoratedclient.h"
 #include "decoration_p.h"
 #include "decorationbutton.h"
+#include "decorationbutton_p.h"
+#include "decorationbuttongroup.h"
+#include "decorationbuttongroup_p.h"
+#include "decorationcounters_p.h"
+#include "decorationrenderscheduler.h"
 #include "decorationsettings.h"
+#include "decorationsnapshot.h"
+#include "decorationtrace_p.h"
 #include "private/decoratedclientprivate.h"
 #include "private/decorationbridge.h"
 
 #include <QCoreApplication>
 #include <QHoverEvent>
+#include <QSet>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
 
 namespace KDecoration2
 {
@@ -27,6 +39,9 @@ DecorationBridge *findBridge(const QVariantList &args)
     }
     Q_UNREACHABLE();
 }
+
+// the first of all Decorations alive on the thread, for Decoration::totalMemoryUsage
+thread_local Decoration *s_decorations = nullptr;
 }
 
 Decoration::Private::Private(Decoration *deco, const QVariantList &args)
@@ -37,6 +52,89 @@ Decoration::Private::Private(Decoration *deco, const QVariantList &args)
     , q(deco)
 {
     Q_UNUSED(args)
+    renderTargets.append({1.0, QRegion()});
+    toolTips.setShowCallback([this](const QString &text) {
+        client->d->requestShowToolTip(text);
+    });
+    toolTips.setHideCallback([this] {
+        client->d->requestHideToolTip();
+    });
+    toolTips.setWakeUpCallback([this](int msec) {
+        scheduleToolTipUpdate(msec);
+    });
+}
+
+void Decoration::Private::deferAction(DeferredAction::Type type, Qt::MouseButtons buttons, const QRect &rect)
+{
+    deferredActions.append({type, buttons, rect});
+    if (!m_deferredActionsTimer) {
+        m_deferredActionsTimer = new QTimer(q);
+        m_deferredActionsTimer->setSingleShot(true);
+        m_deferredActionsTimer->setInterval(0);
+        QObject::connect(m_deferredActionsTimer, &QTimer::timeout, q, [this] {
+            runDeferredActions();
+        });
+    }
+    if (!m_deferredActionsTimer->isActive()) {
+        m_deferredActionsTimer->start();
+    }
+}
+
+void Decoration::Private::runDeferredActions()
+{
+    // any action may destroy the Decoration, so work on a copy
+    const QVarLengthArray<DeferredAction, 4> actions = deferredActions;
+    deferredActions.clear();
+    QPointer<Decoration> decoration(q);
+    for (const DeferredAction &action : actions) {
+        if (!decoration) {
+            return;
+        }
+        switch (action.type) {
+        case DeferredAction::Type::ShowWindowMenu:
+            decoration->requestShowWindowMenu(action.rect);
+            break;
+        case DeferredAction::Type::ShowApplicationMenu:
+            decoration->requestShowApplicationMenu(action.rect, 0 /* actionId */);
+            break;
+        case DeferredAction::Type::Close:
+            decoration->requestClose();
+            break;
+        case DeferredAction::Type::ContextHelp:
+            decoration->requestContextHelp();
+            break;
+        case DeferredAction::Type::Minimize:
+            decoration->requestMinimize();
+            break;
+        case DeferredAction::Type::ToggleOnAllDesktops:
+            decoration->requestToggleOnAllDesktops();
+            break;
+        case DeferredAction::Type::ToggleShade:
+            decoration->requestToggleShade();
+            break;
+        case DeferredAction::Type::ToggleKeepAbove:
+            decoration->requestToggleKeepAbove();
+            break;
+        case DeferredAction::Type::ToggleKeepBelow:
+            decoration->requestToggleKeepBelow();
+            break;
+        case DeferredAction::Type::ToggleMaximization:
+            decoration->requestToggleMaximization(action.buttons);
+            break;
+        }
+    }
+}
+
+void Decoration::Private::scheduleToolTipUpdate(int msec)
+{
+    if (!m_toolTipTimer) {
+        m_toolTipTimer = new QTimer(q);
+        m_toolTipTimer->setSingleShot(true);
+        QObject::connect(m_toolTipTimer, &QTimer::timeout, q, [this] {
+            toolTips.advance();
+        });
+    }
+    m_toolTipTimer->start(msec);
 }
 
 void Decoration::Private::setSectionUnderMouse(Qt::WindowFrameSection section)
@@ -50,6 +148,7 @@ void Decoration::Private::setSectionUnderMouse(Qt::WindowFrameSection section)
 
 void Decoration::Private::updateSectionUnderMouse(const QPoint &mousePosition)
 {
+    KDECORATION2_TRACE_SCOPE("Decoration::updateSectionUnderMouse");
     if (titleBar.contains(mousePosition)) {
         setSectionUnderMouse(Qt::TitleBarArea);
         return;
@@ -113,20 +212,31 @@ void Decoration::Private::updateSectionUnderMouse(const QPoint &mousePosition)
 
 void Decoration::Private::addButton(DecorationButton *button)
 {
-    Q_ASSERT(!buttons.contains(button));
-    buttons << button;
+    buttons.add(button);
     QObject::connect(button, &QObject::destroyed, q, [this](QObject *o) {
-        auto it = buttons.begin();
-        while (it != buttons.end()) {
-            if (*it == static_cast<DecorationButton *>(o)) {
-                it = buttons.erase(it);
-            } else {
-                it++;
-            }
-        }
+        buttons.remove(static_cast<DecorationButton *>(o));
     });
 }
 
+void Decoration::Private::addDeferredButtonGroup(DecorationButtonGroup *group)
+{
+    deferredButtonGroups << QPointer<DecorationButtonGroup>(group);
+}
+
+void Decoration::Private::materializeButtons()
+{
+    if (deferredButtonGroups.isEmpty()) {
+        return;
+    }
+    QVector<QPointer<DecorationButtonGroup>> groups;
+    groups.swap(deferredButtonGroups);
+    for (const auto &group : groups) {
+        if (group) {
+            group->d->materializeButtons();
+        }
+    }
+}
+
 Decoration::Decoration(QObject *parent, const QVariantList &args)
     : QObject(parent)
     , d(new Private(this, args))
@@ -134,9 +244,33 @@ Decoration::Decoration(QObject *parent, const QVariantList &args)
     connect(this, &Decoration::bordersChanged, this, [this] {
         update();
     });
+    d->decorations = &s_decorations;
+    d->nextDecoration = s_decorations;
+    if (s_decorations) {
+        s_decorations->d->previousDecoration = this;
+    }
+    s_decorations = this;
 }
 
-Decoration::~Decoration() = default;
+Decoration::~Decoration()
+{
+    // waits for the render jobs painting the Decoration on worker threads
+    const auto renderSchedulers = d->renderSchedulers;
+    for (DecorationRenderScheduler *scheduler : renderSchedulers) {
+        scheduler->remove(this);
+    }
+    // the DecorationButtons are gone, nobody would hide the tooltip anymore
+    d->toolTips.reset();
+    Q_ASSERT_X(d->decorations == &s_decorations, "~Decoration", "a Decoration must be destroyed on the thread it was created on");
+    if (d->previousDecoration) {
+        d->previousDecoration->d->nextDecoration = d->nextDecoration;
+    } else {
+        *d->decorations = d->nextDecoration;
+    }
+    if (d->nextDecoration) {
+        d->nextDecoration->d->previousDecoration = d->previousDecoration;
+    }
+}
 
 void Decoration::init()
 {
@@ -178,12 +312,32 @@ void Decoration::requestShowWindowMenu(const QRect &rect)
 
 void Decoration::requestShowToolTip(const QString &text)
 {
-    d->client->d->requestShowToolTip(text);
+    d->toolTips.show(text);
 }
 
 void Decoration::requestHideToolTip()
 {
-    d->client->d->requestHideToolTip();
+    d->toolTips.hide();
+}
+
+int Decoration::toolTipShowDelay() const
+{
+    return d->toolTips.showDelay();
+}
+
+void Decoration::setToolTipShowDelay(int msec)
+{
+    d->toolTips.setShowDelay(msec);
+}
+
+int Decoration::toolTipHideGracePeriod() const
+{
+    return d->toolTips.hideGracePeriod();
+}
+
+void Decoration::setToolTipHideGracePeriod(int msec)
+{
+    d->toolTips.setHideGracePeriod(msec);
 }
 
 void Decoration::requestToggleMaximization(Qt::MouseButtons buttons)
@@ -193,12 +347,12 @@ void Decoration::requestToggleMaximization(Qt::MouseButtons buttons)
 
 void Decoration::showApplicationMenu(int actionId)
 {
-    auto it = std::find_if(d->buttons.constBegin(), d->buttons.constEnd(), [](DecorationButton *button) {
-        return button->type() == DecorationButtonType::ApplicationMenu;
-    });
-
-    if (it != d->buttons.constEnd()) {
-        requestShowApplicationMenu((*it)->geometry().toRect(), actionId);
+    d->materializeButtons();
+    for (int i = 0; i < d->buttons.count(); ++i) {
+        if (d->buttons.type(i) == DecorationButtonType::ApplicationMenu) {
+            requestShowApplicationMenu(d->buttons.button(i)->geometry().toRect(), actionId);
+            return;
+        }
     }
 }
 
@@ -276,6 +430,23 @@ QRect Decoration::rect() const
 
 bool Decoration::event(QEvent *event)
 {
+    KDECORATION2_TRACE_SCOPE("Decoration::event");
+    switch (event->type()) {
+    case QEvent::HoverEnter:
+    case QEvent::HoverLeave:
+    case QEvent::HoverMove:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+        Counters::add(Counters::EventsDispatched);
+        // buttons of deferred DecorationButtonGroups need to exist before they can take input
+        d->materializeButtons();
+        break;
+    default:
+        break;
+    }
+
     switch (event->type()) {
     case QEvent::HoverEnter:
         hoverEnterEvent(static_cast<QHoverEvent *>(event));
@@ -303,72 +474,79 @@ bool Decoration::event(QEvent *event)
     }
 }
 
+// The event handlers use the DecorationButtonModel to find the DecorationButtons an
+// event is relevant for. Sending an event might add or remove buttons, therefore the
+// loops go through DecorationButtonModel::forEach.
+
 void Decoration::hoverEnterEvent(QHoverEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        QCoreApplication::instance()->sendEvent(button, event);
-    }
+    // every button gets the enter and leave events, overridden handlers rely on that
+    const auto &buttons = d->buttons;
+    buttons.forEach([&buttons, event](int i) {
+        QCoreApplication::instance()->sendEvent(buttons.button(i), event);
+    });
     d->updateSectionUnderMouse(event->pos());
 }
 
 void Decoration::hoverLeaveEvent(QHoverEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        QCoreApplication::instance()->sendEvent(button, event);
-    }
+    const auto &buttons = d->buttons;
+    buttons.forEach([&buttons, event](int i) {
+        QCoreApplication::instance()->sendEvent(buttons.button(i), event);
+    });
     d->setSectionUnderMouse(Qt::NoSection);
 }
 
 void Decoration::hoverMoveEvent(QHoverEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (!button->isEnabled() || !button->isVisible()) {
-            continue;
+    const auto &buttons = d->buttons;
+    buttons.forEach([&buttons, event](int i) {
+        if (!buttons.testState(i, DecorationButtonModel::Enabled | DecorationButtonModel::Visible)) {
+            return;
         }
-        const bool hovered = button->isHovered();
-        const bool contains = button->contains(event->posF());
+        const bool hovered = buttons.testState(i, DecorationButtonModel::Hovered);
+        const bool contains = buttons.contains(i, event->posF());
         if (!hovered && contains) {
             QHoverEvent e(QEvent::HoverEnter, event->posF(), event->oldPosF(), event->modifiers());
-            QCoreApplication::instance()->sendEvent(button, &e);
+            QCoreApplication::instance()->sendEvent(buttons.button(i), &e);
         } else if (hovered && !contains) {
             QHoverEvent e(QEvent::HoverLeave, event->posF(), event->oldPosF(), event->modifiers());
-            QCoreApplication::instance()->sendEvent(button, &e);
+            QCoreApplication::instance()->sendEvent(buttons.button(i), &e);
         } else if (hovered && contains) {
-            QCoreApplication::instance()->sendEvent(button, event);
+            QCoreApplication::instance()->sendEvent(buttons.button(i), event);
         }
-    }
+    });
     d->updateSectionUnderMouse(event->pos());
 }
 
 void Decoration::mouseMoveEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isPressed()) {
-            QCoreApplication::instance()->sendEvent(button, event);
-            return;
-        }
+    const int index = d->buttons.firstWithState(DecorationButtonModel::Pressed);
+    if (index != -1) {
+        QCoreApplication::instance()->sendEvent(d->buttons.button(index), event);
+        return;
     }
     // not handled, take care ourselves
 }
 
 void Decoration::mousePressEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isHovered()) {
-            if (button->acceptedButtons().testFlag(event->button())) {
-                QCoreApplication::instance()->sendEvent(button, event);
-            }
-            event->setAccepted(true);
-            return;
+    const int index = d->buttons.firstWithState(DecorationButtonModel::Hovered);
+    if (index != -1) {
+        if (d->buttons.accepts(index, event->button())) {
+            QCoreApplication::instance()->sendEvent(d->buttons.button(index), event);
         }
+        event->setAccepted(true);
+        return;
     }
 }
 
 void Decoration::mouseReleaseEvent(QMouseEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->isPressed() && button->acceptedButtons().testFlag(event->button())) {
-            QCoreApplication::instance()->sendEvent(button, event);
+    const auto &buttons = d->buttons;
+    for (int i = 0; i < buttons.count(); ++i) {
+        if (buttons.testState(i, DecorationButtonModel::Pressed) && buttons.accepts(i, event->button())) {
+            QCoreApplication::instance()->sendEvent(buttons.button(i), event);
             return;
         }
     }
@@ -378,17 +556,348 @@ void Decoration::mouseReleaseEvent(QMouseEvent *event)
 
 void Decoration::wheelEvent(QWheelEvent *event)
 {
-    for (DecorationButton *button : d->buttons) {
-        if (button->contains(event->posF())) {
-            QCoreApplication::instance()->sendEvent(button, event);
+    const auto &buttons = d->buttons;
+    buttons.forEach([&buttons, event](int i) {
+        if (buttons.contains(i, event->posF())) {
+            QCoreApplication::instance()->sendEvent(buttons.button(i), event);
             event->setAccepted(true);
         }
+    });
+}
+
+// geometry snapped to physical pixels is only close to whole numbers after scaling,
+// don't let the rounding error grow or shrink a rect by another pixel
+static const qreal s_snapEpsilon = 1.0 / 256;
+// the damage of a scale is only taken once it gets rendered, which some bridges never do
+static const int s_maximumDamageRects = 16;
+
+static void addDamage(QRegion &damage, const QRect &rect)
+{
+    damage += rect;
+    if (damage.rectCount() > s_maximumDamageRects) {
+        damage = damage.boundingRect();
+    }
+}
+
+QRect Decoration::Private::toDevicePixels(const QRectF &rect, qreal scale)
+{
+    const int left = std::floor(rect.left() * scale + s_snapEpsilon);
+    const int top = std::floor(rect.top() * scale + s_snapEpsilon);
+    const int right = std::ceil(rect.right() * scale - s_snapEpsilon);
+    const int bottom = std::ceil(rect.bottom() * scale - s_snapEpsilon);
+    return QRect(left, top, right - left, bottom - top);
+}
+
+Decoration::Private::RenderTarget *Decoration::Private::renderTarget(qreal scale)
+{
+    for (RenderTarget &target : renderTargets) {
+        if (qFuzzyCompare(target.scale, scale)) {
+            return &target;
+        }
+    }
+    return nullptr;
+}
+
+QRegion Decoration::Private::takeDamage(qreal scale, const void *consumer)
+{
+    RenderTarget *target = renderTarget(scale);
+    if (!target) {
+        return QRegion();
+    }
+    // a second consumer would miss the damage taken by the first one
+    Q_ASSERT_X(!target->consumer || target->consumer == consumer, "takeDamage", "the damage of a scale is taken by more than one consumer");
+    if (!target->isTracked()) {
+        // the damage so far is unknown
+        target->consumer = consumer;
+        return toDevicePixels(q->rect(), scale);
+    }
+    target->consumer = consumer;
+    QRegion damage;
+    damage.swap(target->damage);
+    return damage;
+}
+
+void Decoration::Private::releaseDamage(const void *consumer)
+{
+    for (RenderTarget &target : renderTargets) {
+        if (target.consumer == consumer) {
+            target.consumer = nullptr;
+            if (!target.isTracked()) {
+                target.damage = QRegion();
+            }
+        }
+    }
+}
+
+void Decoration::Private::damage(const QRectF &rect)
+{
+    // by index, the bridge might change the scales while being notified
+    for (int i = 0; i < renderTargets.count(); ++i) {
+        damage(renderTargets[i], rect);
+    }
+}
+
+void Decoration::Private::damage(RenderTarget &target, const QRectF &rect)
+{
+    const qreal scale = target.scale;
+    if (qFuzzyCompare(scale, 1.0)) {
+        const QRect geometry = rect.toAlignedRect();
+        if (target.isTracked()) {
+            addDamage(target.damage, geometry);
+        }
+        Counters::add(Counters::BridgeUpdates);
+        Counters::add(Counters::PixelsDamaged, qint64(geometry.width()) * geometry.height());
+        {
+            KDECORATION2_TRACE_SCOPE("DecorationBridge::update");
+            bridge->update(q, geometry);
+        }
+        if (Q_UNLIKELY(damageObserver)) {
+            damageObserver(geometry, scale);
+        }
+    } else {
+        const QRect deviceGeometry = toDevicePixels(rect, scale);
+        if (target.isTracked()) {
+            addDamage(target.damage, deviceGeometry);
+        }
+        Counters::add(Counters::BridgeUpdates);
+        Counters::add(Counters::PixelsDamaged, qint64(deviceGeometry.width()) * deviceGeometry.height());
+        {
+            KDECORATION2_TRACE_SCOPE("DecorationBridge::updateScaled");
+            bridge->updateScaled(q, deviceGeometry, scale);
+        }
+        if (Q_UNLIKELY(damageObserver)) {
+            damageObserver(deviceGeometry, scale);
+        }
     }
 }
 
 void Decoration::update(const QRect &r)
 {
-    d->bridge->update(this, r.isNull() ? rect() : r);
+    KDECORATION2_TRACE_SCOPE("Decoration::update");
+    d->damage(r.isNull() ? rect() : r);
+}
+
+qreal Decoration::devicePixelRatio() const
+{
+    return d->devicePixelRatio;
+}
+
+void Decoration::setDevicePixelRatio(qreal ratio)
+{
+    setScales({ratio});
+}
+
+QVector<qreal> Decoration::scales() const
+{
+    QVector<qreal> scales;
+    scales.reserve(d->renderTargets.count());
+    for (const auto &target : d->renderTargets) {
+        scales << target.scale;
+    }
+    return scales;
+}
+
+void Decoration::setScales(const QVector<qreal> &scales)
+{
+    QVarLengthArray<Private::RenderTarget, 2> targets;
+    QVector<qreal> added;
+    for (qreal scale : scales) {
+        const bool duplicate = std::any_of(targets.cbegin(), targets.cend(), [scale](const Private::RenderTarget &target) {
+            return qFuzzyCompare(target.scale, scale);
+        });
+        if (scale <= 0 || duplicate) {
+            continue;
+        }
+        if (const Private::RenderTarget *target = d->renderTarget(scale)) {
+            targets.append(*target);
+        } else {
+            targets.append({scale, QRegion()});
+            added << scale;
+        }
+    }
+    if (targets.isEmpty() || (added.isEmpty() && targets.count() == d->renderTargets.count())) {
+        return;
+    }
+    std::sort(targets.begin(), targets.end(), [](const Private::RenderTarget &a, const Private::RenderTarget &b) {
+        return a.scale > b.scale;
+    });
+    d->renderTargets = targets;
+    emit scalesChanged();
+
+    const qreal ratio = d->renderTargets.first().scale;
+    if (!qFuzzyCompare(d->devicePixelRatio, ratio)) {
+        d->devicePixelRatio = ratio;
+        emit devicePixelRatioChanged(ratio);
+    }
+    // nothing has been rendered at the new scales yet
+    for (qreal scale : qAsConst(added)) {
+        // might have been removed again from within a signal
+        if (Private::RenderTarget *target = d->renderTarget(scale)) {
+            d->damage(*target, rect());
+        }
+    }
+}
+
+QRegion Decoration::damage(qreal scale) const
+{
+    for (const auto &target : d->renderTargets) {
+        if (qFuzzyCompare(target.scale, scale)) {
+            return target.damage;
+        }
+    }
+    return QRegion();
+}
+
+namespace
+{
+/**
+ * What the Decoration painted on the current thread gets rendered with.
+ **/
+struct RenderContext {
+    const Decoration *decoration;
+    qreal scale;
+    const DecorationSnapshot *snapshot;
+};
+thread_local const RenderContext *s_renderContext = nullptr;
+}
+
+void Decoration::Private::paint(QPainter *painter, const QRect &repaintArea, qreal scale, const DecorationSnapshot *snapshot)
+{
+    const RenderContext context{q, scale, snapshot};
+    const RenderContext *previousContext = s_renderContext;
+    s_renderContext = &context;
+    q->paint(painter, repaintArea);
+    s_renderContext = previousContext;
+}
+
+qreal Decoration::renderScale() const
+{
+    if (s_renderContext && s_renderContext->decoration == this) {
+        return s_renderContext->scale;
+    }
+    return d->devicePixelRatio;
+}
+
+DecorationSnapshot Decoration::renderSnapshot() const
+{
+    if (s_renderContext && s_renderContext->decoration == this && s_renderContext->snapshot) {
+        return *s_renderContext->snapshot;
+    }
+    return DecorationSnapshot(this);
+}
+
+qint64 DecorationMemoryUsage::total() const
+{
+    return decoration + damage + buttons + buttonGroups + shadow;
+}
+
+DecorationMemoryUsage &DecorationMemoryUsage::operator+=(const DecorationMemoryUsage &other)
+{
+    decoration += other.decoration;
+    damage += other.damage;
+    buttons += other.buttons;
+    buttonGroups += other.buttonGroups;
+    shadow += other.shadow;
+    return *this;
+}
+
+namespace
+{
+template<typename Container>
+qint64 heapSize(const Container &container)
+{
+    return qint64(container.capacity()) * sizeof(typename Container::value_type);
+}
+
+template<typename T, int Prealloc>
+qint64 heapSize(const QVarLengthArray<T, Prealloc> &array)
+{
+    // only allocated once the preallocated space is exceeded
+    return array.capacity() > Prealloc ? qint64(array.capacity()) * sizeof(T) : 0;
+}
+}
+
+DecorationMemoryUsage Decoration::memoryUsage() const
+{
+    DecorationMemoryUsage usage;
+    // the DecoratedClient is owned by the bridge and shared with it
+    usage.decoration = sizeof(Decoration) + sizeof(Private);
+    usage.decoration += heapSize(d->renderTargets) + heapSize(d->deferredActions) + heapSize(d->deferredButtonGroups);
+    // the DecorationButtonModel only keeps a pointer per button
+    const int buttonCount = d->buttons.count();
+    usage.decoration += qint64(d->buttons.buttons().capacity()) * sizeof(DecorationButton *);
+
+    for (const auto &target : d->renderTargets) {
+        usage.damage += target.damage.rectCount() * sizeof(QRect);
+    }
+
+    usage.buttons = buttonCount * qint64(sizeof(DecorationButton) + sizeof(DecorationButton::Private));
+
+    const auto groups = findChildren<DecorationButtonGroup *>();
+    for (const DecorationButtonGroup *group : groups) {
+        usage.buttonGroups += sizeof(DecorationButtonGroup) + sizeof(DecorationButtonGroup::Private);
+        usage.buttonGroups += heapSize(group->d->buttons) + heapSize(group->d->deferredButtons);
+    }
+
+    if (d->shadow) {
+        usage.shadow = sizeof(DecorationShadow) + d->shadow->shadow().sizeInBytes();
+    }
+    return usage;
+}
+
+DecorationMemoryUsage Decoration::totalMemoryUsage()
+{
+    DecorationMemoryUsage usage;
+    QSet<const DecorationShadow *> shadows;
+    for (const Decoration *decoration = s_decorations; decoration; decoration = decoration->d->nextDecoration) {
+        DecorationMemoryUsage decorationUsage = decoration->memoryUsage();
+        if (decorationUsage.shadow) {
+            const DecorationShadow *shadow = decoration->d->shadow.data();
+            if (shadows.contains(shadow)) {
+                decorationUsage.shadow = 0;
+            } else {
+                shadows.insert(shadow);
+            }
+        }
+        usage += decorationUsage;
+    }
+    return usage;
+}
+
+bool Decoration::supportsThreadedRendering() const
+{
+    return d->supportsThreadedRendering;
+}
+
+void Decoration::setSupportsThreadedRendering(bool supports)
+{
+    d->supportsThreadedRendering = supports;
+}
+
+void Decoration::render(QPainter *painter, const QRect &repaintArea, qreal scale)
+{
+    if (Private::RenderTarget *target = d->renderTarget(scale)) {
+        target->rendered = true;
+        // only physical pixels completely inside the repaintArea get repainted,
+        // damage added while painting is kept for the next render
+        const int left = std::ceil(repaintArea.left() * scale - s_snapEpsilon);
+        const int top = std::ceil(repaintArea.top() * scale - s_snapEpsilon);
+        const int right = std::floor((repaintArea.x() + repaintArea.width()) * scale + s_snapEpsilon);
+        const int bottom = std::floor((repaintArea.y() + repaintArea.height()) * scale + s_snapEpsilon);
+        target->damage -= QRect(left, top, right - left, bottom - top);
+    }
+    d->paint(painter, repaintArea, scale, nullptr);
+}
+
+QRectF Decoration::snapToDevicePixels(const QRectF &rect) const
+{
+    const qreal ratio = d->devicePixelRatio;
+    auto snap = [ratio](qreal value) {
+        return std::round(value * ratio) / ratio;
+    };
+    const qreal left = snap(rect.left());
+    const qreal top = snap(rect.top());
+    return QRectF(left, top, snap(rect.right()) - left, snap(rect.bottom()) - top);
 }
 
 void Decoration::update()
@@ -406,4 +915,39 @@ QSharedPointer<DecorationSettings> Decoration::settings() const
     return d->settings;
 }
 
+void Decoration::recycle()
+{
+    d->setSectionUnderMouse(Qt::NoSection);
+    const auto buttons = d->buttons.buttons();
+    for (DecorationButton *button : buttons) {
+        button->d->resetInputState();
+    }
+    d->toolTips.reset();
+    d->deferredActions.clear();
+    d->client->detach();
+
+    setBorders(QMargins());
+    setResizeOnlyBorders(QMargins());
+    setTitleBar(QRect());
+    setShadow(QSharedPointer<DecorationShadow>());
+    const auto schedulers = d->renderSchedulers;
+    for (DecorationRenderScheduler *scheduler : schedulers) {
+        scheduler->remove(this);
+    }
+    setScales({1.0});
+    // the next window starts untracked without any consumer
+    d->renderTargets.first() = Private::RenderTarget{1.0, QRegion()};
+
+    // might delete this Decoration
+    d->bridge->recycleDecoration(this);
+}
+
+void Decoration::rebind(QObject *parent)
+{
+    // the bridge finds the window through the parent
+    setParent(parent);
+    d->client->rebind(d->bridge);
+    update();
+}
+
 } // namespace
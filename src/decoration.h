@@ -13,10 +13,12 @@
 #include <QObject>
 #include <QPointer>
 #include <QRect>
+#include <QVector>
 
 class QHoverEvent;
 class QMouseEvent;
 class QPainter;
+class QRegion;
 class QWheelEvent;
 
 /**
@@ -29,6 +31,36 @@ class DecorationPrivate;
 class DecoratedClient;
 class DecorationButton;
 class DecorationSettings;
+class DecorationSnapshot;
+
+/**
+ * @brief The memory held by a Decoration in bytes, as returned by Decoration::memoryUsage.
+ *
+ * The values are estimates from the library's point of view: the sizes of subclasses of
+ * Decoration and DecorationButton and the heap allocations of QObject itself are unknown
+ * to it. Back-buffers owned by the compositor, e.g. a DecorationTileBuffer, are not included.
+ *
+ * @since 5.22
+ **/
+struct KDECORATIONS2_EXPORT DecorationMemoryUsage {
+    /**
+     * The Decoration, its DecoratedClient and their internal state.
+     **/
+    qint64 decoration = 0;
+    /**
+     * The damage regions of all scales.
+     **/
+    qint64 damage = 0;
+    qint64 buttons = 0;
+    qint64 buttonGroups = 0;
+    /**
+     * The DecorationShadow and its image, which is commonly shared by multiple Decorations.
+     **/
+    qint64 shadow = 0;
+
+    qint64 total() const;
+    DecorationMemoryUsage &operator+=(const DecorationMemoryUsage &other);
+};
 
 /**
  * @brief Base class for the Decoration.
@@ -87,6 +119,13 @@ class KDECORATIONS2_EXPORT Decoration : public QObject
      * Decoration should set this property to @c true.
      **/
     Q_PROPERTY(bool opaque READ isOpaque NOTIFY opaqueChanged)
+    /**
+     * The highest of the scales the Decoration is rendered for. DecorationButtonGroups align
+     * their buttons to the physical pixels of this scale and damage is passed to the
+     * DecorationBridge in physical pixels. By default @c 1.0.
+     * @since 5.22
+     **/
+    Q_PROPERTY(qreal devicePixelRatio READ devicePixelRatio NOTIFY devicePixelRatioChanged)
 public:
     ~Decoration() override;
 
@@ -111,6 +150,86 @@ public:
     Qt::WindowFrameSection sectionUnderMouse() const;
     QRect titleBar() const;
     bool isOpaque() const;
+    /**
+     * @since 5.22
+     **/
+    qreal devicePixelRatio() const;
+    /**
+     * Moves all edges of @p rect to the nearest physical pixel boundary for the devicePixelRatio.
+     * Adjacent rects stay adjacent after snapping.
+     * @since 5.22
+     **/
+    QRectF snapToDevicePixels(const QRectF &rect) const;
+    /**
+     * The scales of all outputs the Decoration is shown on, e.g. of both outputs if the window
+     * spans two outputs. Sorted from the highest to the lowest scale, the highest scale is the
+     * devicePixelRatio. By default only @c 1.0.
+     * @see render
+     * @since 5.22
+     **/
+    QVector<qreal> scales() const;
+    /**
+     * The area in physical pixels of @p scale which changed since the Decoration was last
+     * rendered at @p scale. Empty if the Decoration is not shown at @p scale. The damage
+     * is only tracked once the Decoration got rendered at @p scale, before that everything
+     * needs to be rendered.
+     * @since 5.22
+     **/
+    QRegion damage(qreal scale) const;
+    /**
+     * The scale the Decoration is rendered at while paint is invoked from render. A Decoration
+     * can use it to e.g. align lines to physical pixels. Outside of render this is the
+     * devicePixelRatio.
+     * @since 5.22
+     **/
+    qreal renderScale() const;
+    /**
+     * Whether paint may be invoked from a worker thread, e.g. by a DecorationRenderScheduler.
+     * By default @c false.
+     *
+     * A Decoration supporting threaded rendering promises that paint only uses the painter,
+     * the repaintArea, renderScale and renderSnapshot. It must not access the DecoratedClient,
+     * the DecorationSettings, its DecorationButtons or any other QObject, as those are modified
+     * on the GUI thread while paint runs. Multiple scales of the same Decoration might be
+     * painted at the same time.
+     * @see setSupportsThreadedRendering
+     * @since 5.22
+     **/
+    bool supportsThreadedRendering() const;
+    /**
+     * The state the Decoration is rendered with while paint is invoked. Outside of paint
+     * a DecorationSnapshot of the current state.
+     * @see supportsThreadedRendering
+     * @since 5.22
+     **/
+    DecorationSnapshot renderSnapshot() const;
+    /**
+     * The milliseconds between requestShowToolTip and showing the tooltip, by default @c 50.
+     * A tooltip requested shortly after another one got hidden is shown right away.
+     * @see setToolTipShowDelay
+     * @since 5.22
+     **/
+    int toolTipShowDelay() const;
+    /**
+     * The milliseconds between requestHideToolTip and hiding the tooltip, by default @c 50.
+     * If another tooltip is requested in the meantime only its text gets updated.
+     * @see setToolTipHideGracePeriod
+     * @since 5.22
+     **/
+    int toolTipHideGracePeriod() const;
+
+    /**
+     * A breakdown of the memory held by this Decoration.
+     * @since 5.22
+     **/
+    DecorationMemoryUsage memoryUsage() const;
+    /**
+     * The memory held by all Decorations created on the calling thread and still alive,
+     * including recycled ones. DecorationShadows shared by multiple Decorations are counted
+     * once. A Decoration must be destroyed on the thread it was created on.
+     * @since 5.22
+     **/
+    static DecorationMemoryUsage totalMemoryUsage();
 
     /**
      * DecorationShadow for this Decoration. It is recommended that multiple Decorations share
@@ -133,11 +252,52 @@ public:
      * @internal
      **/
     void setSettings(const QSharedPointer<DecorationSettings> &settings);
+    /**
+     * Invoked by the framework whenever the Decoration moves to an output with a different scale.
+     * @internal
+     * @since 5.22
+     **/
+    void setDevicePixelRatio(qreal ratio);
+    /**
+     * Invoked by the framework whenever the set of outputs the Decoration is shown on changes.
+     * Scales which were not shown before are completely damaged, the damage of other scales
+     * is kept. The devicePixelRatio becomes the highest of the @p scales.
+     * @internal
+     * @since 5.22
+     **/
+    void setScales(const QVector<qreal> &scales);
     /**
      * @returns The DecorationSettings used for this Decoration.
      **/
     QSharedPointer<DecorationSettings> settings() const;
 
+    /**
+     * Invoked by the framework instead of deleting the Decoration once the window it decorates
+     * is gone. The Decoration releases the backend of its DecoratedClient, resets the input state
+     * of its DecorationButtons and is handed to the DecorationBridge for reuse by another window.
+     * If the DecorationBridge's pool is full the Decoration gets deleted.
+     *
+     * Nothing of the previous window is kept: the borders, resize only borders and title bar
+     * are reset to empty, the shadow is unset, the only scale is @c 1 and the Decoration is
+     * removed from its DecorationRenderSchedulers, which includes the damage tracked for the
+     * consumers of its scales.
+     * @see rebind
+     * @internal
+     * @since 5.22
+     **/
+    void recycle();
+    /**
+     * Invoked by the framework to bind a recycled Decoration to a new window. The Decoration
+     * becomes a child of @p parent, like the @c parent passed to the constructor, before the
+     * DecorationBridge creates the backend of the DecoratedClient, so that the bridge finds the
+     * new window through parent(). All change signals of the DecoratedClient get emitted, so
+     * that the Decoration and its DecorationButtons pick up the state of the new window.
+     * @see recycle
+     * @internal
+     * @since 5.22
+     **/
+    void rebind(QObject *parent);
+
     /**
      * Implement this method in inheriting classes to provide the rendering.
      *
@@ -148,6 +308,17 @@ public:
      * @param repaintArea The region which needs to be repainted.
      **/
     virtual void paint(QPainter *painter, const QRect &repaintArea) = 0;
+    /**
+     * Invoked by the framework to render the Decoration into the buffer of one of its scales.
+     * The @p painter needs to paint on a device with a device pixel ratio of @p scale, the
+     * @p repaintArea is in logical coordinates.
+     *
+     * Invokes paint with renderScale set to @p scale and removes the @p repaintArea from
+     * the damage of @p scale.
+     * @internal
+     * @since 5.22
+     **/
+    void render(QPainter *painter, const QRect &repaintArea, qreal scale);
 
     bool event(QEvent *event) override;
 
@@ -174,7 +345,17 @@ public Q_SLOTS:
      * @param rect the location at which to show the window menu
      */
     void requestShowWindowMenu(const QRect &rect);
+    /**
+     * Requests showing a tooltip with @p text.
+     *
+     * Tooltip requests are coalesced: showing a tooltip shortly after hiding
+     * another one only updates the text of the visible tooltip.
+     **/
     void requestShowToolTip(const QString &text);
+    /**
+     * Requests hiding the tooltip. The tooltip is hidden after the toolTipHideGracePeriod,
+     * unless a new tooltip is requested in the meantime.
+     **/
     void requestHideToolTip();
 
     void showApplicationMenu(int actionId);
@@ -199,6 +380,14 @@ Q_SIGNALS:
     void titleBarChanged();
     void opaqueChanged(bool);
     void shadowChanged(const QSharedPointer<DecorationShadow> &shadow);
+    /**
+     * @since 5.22
+     **/
+    void devicePixelRatioChanged(qreal ratio);
+    /**
+     * @since 5.22
+     **/
+    void scalesChanged();
 
 protected:
     /**
@@ -222,6 +411,23 @@ protected:
     void setTitleBar(const QRect &rect);
     void setOpaque(bool opaque);
     void setShadow(const QSharedPointer<DecorationShadow> &shadow);
+    /**
+     * @see supportsThreadedRendering
+     * @since 5.22
+     **/
+    void setSupportsThreadedRendering(bool supports);
+    /**
+     * Setting the delay to @c 0 shows tooltips as soon as they are requested.
+     * @see toolTipShowDelay
+     * @since 5.22
+     **/
+    void setToolTipShowDelay(int msec);
+    /**
+     * Setting the period to @c 0 hides tooltips as soon as it is requested.
+     * @see toolTipHideGracePeriod
+     * @since 5.22
+     **/
+    void setToolTipHideGracePeriod(int msec);
 
     virtual void hoverEnterEvent(QHoverEvent *event);
     virtual void hoverLeaveEvent(QHoverEvent *event);
@@ -233,6 +439,12 @@ protected:
 
 private:
     friend class DecorationButton;
+    friend class DecorationButtonGroup;
+    friend class DecorationRecorder;
+    friend class DecorationRenderScheduler;
+    friend class DecorationSharedBuffer;
+    friend class DecorationSnapshot;
+    friend class DecorationTileBuffer;
     class Private;
     QScopedPointer<Private> d;
 };
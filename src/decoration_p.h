@@ -6,6 +6,16 @@
 #ifndef KDECORATION2_DECORATION_P_H
 #define KDECORATION2_DECORATION_P_H
 #include "decoration.h"
+#include "decorationbuttonmodel_p.h"
+#include "decorationtimerservice_p.h"
+#include "decorationtooltipscheduler_p.h"
+
+#include <QRegion>
+#include <QVarLengthArray>
+
+#include <functional>
+
+class QTimer;
 
 //
 //  W A R N I N G
@@ -23,9 +33,12 @@ namespace KDecoration2
 class Decoration;
 class DecorationBridge;
 class DecorationButton;
+class DecorationButtonGroup;
+class DecorationRenderScheduler;
 class DecoratedClient;
 class DecorationSettings;
 class DecorationShadow;
+class DecorationSnapshot;
 
 class Q_DECL_HIDDEN Decoration::Private
 {
@@ -40,17 +53,129 @@ public:
     void updateSectionUnderMouse(const QPoint &mousePosition);
 
     QRect titleBar;
+    qreal devicePixelRatio = 1.0;
+    /**
+     * Passes @p rect to the bridge once for each scale, in physical pixels if the scale
+     * is not @c 1, and adds it to the damage of the scale's RenderTarget if it is tracked.
+     * The damage is reduced to its bounding rect once it consists of too many rects.
+     **/
+    void damage(const QRectF &rect);
+    /**
+     * The damage of one of the scales the Decoration is rendered at, in physical pixels.
+     **/
+    struct RenderTarget {
+        qreal scale;
+        QRegion damage;
+        /**
+         * Taking the damage clears it, so only one DecorationTileBuffer, DecorationSharedBuffer
+         * or DecorationRenderScheduler may render a scale at a time.
+         **/
+        const void *consumer = nullptr;
+        // Decoration::render got invoked for the scale
+        bool rendered = false;
+        /**
+         * Bridges which never render a scale themselves don't pay for tracking its damage.
+         **/
+        bool isTracked() const
+        {
+            return consumer || rendered;
+        }
+    };
+    /**
+     * Sorted by descending scale and never empty, the first scale is the devicePixelRatio.
+     **/
+    QVarLengthArray<RenderTarget, 2> renderTargets;
+    void damage(RenderTarget &target, const QRectF &rect);
+    RenderTarget *renderTarget(qreal scale);
+    /**
+     * Returns the damage of @p scale and clears it, once the back-buffer of @p consumer
+     * gets repainted. Asserts that no other consumer takes the damage of @p scale. The
+     * first consumer of an untracked scale gets all of it.
+     **/
+    QRegion takeDamage(qreal scale, const void *consumer);
+    /**
+     * Lets another consumer take the damage of the scales @p consumer rendered. The damage
+     * of scales nobody renders anymore is dropped.
+     **/
+    void releaseDamage(const void *consumer);
+    static QRect toDevicePixels(const QRectF &rect, qreal scale);
+    /**
+     * Invokes Decoration::paint with renderScale and renderSnapshot set up for the
+     * current thread. A @p snapshot of @c nullptr means the current state.
+     **/
+    void paint(QPainter *painter, const QRect &repaintArea, qreal scale, const DecorationSnapshot *snapshot);
+    bool supportsThreadedRendering = false;
+    /**
+     * The DecorationRenderSchedulers the Decoration is scheduled on. ~Decoration removes
+     * it from them, so that no render job uses the Private once it is gone.
+     **/
+    QVector<DecorationRenderScheduler *> renderSchedulers;
+    /**
+     * Invoked with all damage passed to the bridge, used by DecorationRecorder.
+     **/
+    std::function<void(const QRect &geometry, qreal scale)> damageObserver;
 
     void addButton(DecorationButton *button);
+    void addDeferredButtonGroup(DecorationButtonGroup *group);
+    /**
+     * Creates the buttons of all DecorationButtonGroups which deferred creating them.
+     **/
+    void materializeButtons();
 
     QSharedPointer<DecorationSettings> settings;
     DecorationBridge *bridge;
     QSharedPointer<DecoratedClient> client;
     bool opaque;
-    QVector<DecorationButton *> buttons;
+    DecorationButtonModel buttons;
+    QVector<QPointer<DecorationButtonGroup>> deferredButtonGroups;
     QSharedPointer<DecorationShadow> shadow;
+    DecorationToolTipScheduler toolTips;
+    /**
+     * Shared by all buttons, e.g. for press and hold.
+     **/
+    DecorationTimerService timers;
+
+    /**
+     * A request triggered by a DecorationButton.
+     **/
+    struct DeferredAction {
+        enum class Type {
+            ShowWindowMenu,
+            ShowApplicationMenu,
+            Close,
+            ContextHelp,
+            Minimize,
+            ToggleOnAllDesktops,
+            ToggleShade,
+            ToggleKeepAbove,
+            ToggleKeepBelow,
+            ToggleMaximization,
+        };
+        Type type;
+        Qt::MouseButtons buttons;
+        QRect rect;
+    };
+    /**
+     * Queues the request to be performed once control returns to the event loop.
+     * The request might close the window and with that destroy the Decoration,
+     * so it must not be performed while an event is being dispatched.
+     **/
+    void deferAction(DeferredAction::Type type, Qt::MouseButtons buttons = Qt::NoButton, const QRect &rect = QRect());
+    void runDeferredActions();
+    QVarLengthArray<DeferredAction, 4> deferredActions;
+
+    /**
+     * Links all Decorations alive on the thread they were created on, for totalMemoryUsage.
+     * Linking and unlinking needs no lock as it only happens on that thread.
+     **/
+    Decoration **decorations = nullptr;
+    Decoration *previousDecoration = nullptr;
+    Decoration *nextDecoration = nullptr;
 
 private:
+    void scheduleToolTipUpdate(int msec);
+    QTimer *m_toolTipTimer = nullptr;
+    QTimer *m_deferredActionsTimer = nullptr;
     Decoration *q;
 };
 
@@ -8,16 +8,20 @@
 #include "decoration.h"
 #include "decoration_p.h"
 #include "decorationbutton_p.h"
+#include "decorationbuttonmodel_p.h"
+#include "decorationcounters_p.h"
 #include "decorationsettings.h"
+#include "decorationtrace_p.h"
 
 #include <KLocalizedString>
 
+#include <QAtomicInt>
 #include <QDebug>
-#include <QElapsedTimer>
 #include <QGuiApplication>
 #include <QHoverEvent>
+#include <QMutex>
+#include <QPointer>
 #include <QStyleHints>
-#include <QTimer>
 
 namespace KDecoration2
 {
@@ -28,24 +32,72 @@ uint qHash(const DecorationButtonType &type)
 }
 #endif
 
+namespace
+{
+/**
+ * Caches the gesture intervals of the QStyleHints, querying them goes to the platform theme.
+ **/
+class StyleHintsCache
+{
+public:
+    int doubleClickInterval()
+    {
+        update();
+        return m_doubleClickInterval;
+    }
+    int pressAndHoldInterval()
+    {
+        update();
+        return m_pressAndHoldInterval;
+    }
+
+private:
+    void update()
+    {
+        QStyleHints *hints = QGuiApplication::styleHints();
+        if (m_hints == hints) {
+            return;
+        }
+        m_hints = hints;
+        m_doubleClickInterval = hints->mouseDoubleClickInterval();
+        m_pressAndHoldInterval = hints->mousePressAndHoldInterval();
+        QObject::connect(hints, &QStyleHints::mouseDoubleClickIntervalChanged, hints, [this](int interval) {
+            m_doubleClickInterval = interval;
+        });
+        QObject::connect(hints, &QStyleHints::mousePressAndHoldIntervalChanged, hints, [this](int interval) {
+            m_pressAndHoldInterval = interval;
+        });
+    }
+    QPointer<QStyleHints> m_hints;
+    int m_doubleClickInterval = 0;
+    int m_pressAndHoldInterval = 0;
+};
+
+StyleHintsCache s_styleHints;
+}
+
 DecorationButton::Private::Private(DecorationButtonType type, const QPointer<Decoration> &decoration, DecorationButton *parent)
-    : decoration(decoration)
-    , type(type)
-    , hovered(false)
-    , enabled(true)
-    , checkable(false)
-    , checked(false)
-    , visible(true)
+    : type(type)
     , acceptedButtons(Qt::LeftButton)
-    , doubleClickEnabled(false)
-    , pressAndHold(false)
-    , q(parent)
+    , decoration(decoration)
+    , state(Enabled | Visible)
+    , m_lastReleaseSynthesized(false)
     , m_pressed(Qt::NoButton)
+    , q(parent)
+    , m_lastRelease(-1)
 {
+    // geometry, type, accepted buttons, decoration, the packed state and m_pressed fill the
+    // first 64 bytes, q and the last release time the remaining 16
+    static_assert(sizeof(void *) != 8 || sizeof(Private) <= 80, "DecorationButton::Private grew, keep rarely used data out of line");
     init();
+    Counters::add(Counters::ButtonsCreated);
 }
 
-DecorationButton::Private::~Private() = default;
+DecorationButton::Private::~Private()
+{
+    stopPressAndHold();
+    Counters::add(Counters::ButtonsDestroyed);
+}
 
 void DecorationButton::Private::init()
 {
@@ -53,43 +105,37 @@ void DecorationButton::Private::init()
     Q_ASSERT(clientPtr);
     auto c = clientPtr.data();
     auto settings = decoration->settings();
+    using Action = Decoration::Private::DeferredAction::Type;
+    // the actions are performed once control returns to the event loop, the decoration might get destroyed by them
+    auto connectAction = [this](Action action) {
+        QObject::connect(q, &DecorationButton::clicked, decoration.data(), [this, action](Qt::MouseButton button) {
+            decoration->d->deferAction(action, button, q->geometry().toRect());
+        });
+    };
     switch (type) {
     case DecorationButtonType::Menu:
-        QObject::connect(
-            q,
-            &DecorationButton::clicked,
-            decoration.data(),
-            [this](Qt::MouseButton button) {
-                Q_UNUSED(button)
-                decoration->requestShowWindowMenu(q->geometry().toRect());
-            },
-            Qt::QueuedConnection);
-        QObject::connect(q, &DecorationButton::doubleClicked, decoration.data(), &Decoration::requestClose, Qt::QueuedConnection);
+        connectAction(Action::ShowWindowMenu);
+        QObject::connect(q, &DecorationButton::doubleClicked, decoration.data(), [this] {
+            decoration->d->deferAction(Action::Close);
+        });
         QObject::connect(
             settings.data(),
             &DecorationSettings::closeOnDoubleClickOnMenuChanged,
             q,
             [this](bool enabled) {
-                doubleClickEnabled = enabled;
+                setDoubleClickEnabled(enabled);
                 setPressAndHold(enabled);
             },
             Qt::QueuedConnection);
-        doubleClickEnabled = settings->isCloseOnDoubleClickOnMenu();
+        setDoubleClickEnabled(settings->isCloseOnDoubleClickOnMenu());
         setPressAndHold(settings->isCloseOnDoubleClickOnMenu());
         setAcceptedButtons(Qt::LeftButton | Qt::RightButton);
         break;
     case DecorationButtonType::ApplicationMenu:
         setVisible(c->hasApplicationMenu());
         setCheckable(true); // will be "checked" whilst the menu is opened
-        // FIXME TODO connect directly and figure out the button geometry/offset stuff
-        QObject::connect(
-            q,
-            &DecorationButton::clicked,
-            decoration.data(),
-            [this] {
-                decoration->requestShowApplicationMenu(q->geometry().toRect(), 0 /* actionId */);
-            },
-            Qt::QueuedConnection); //&Decoration::requestShowApplicationMenu, Qt::QueuedConnection);
+        // FIXME TODO figure out the button geometry/offset stuff
+        connectAction(Action::ShowApplicationMenu);
         QObject::connect(c, &DecoratedClient::hasApplicationMenuChanged, q, &DecorationButton::setVisible);
         QObject::connect(c, &DecoratedClient::applicationMenuActiveChanged, q, &DecorationButton::setChecked);
         break;
@@ -97,13 +143,13 @@ void DecorationButton::Private::init()
         setVisible(settings->isOnAllDesktopsAvailable());
         setCheckable(true);
         setChecked(c->isOnAllDesktops());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestToggleOnAllDesktops, Qt::QueuedConnection);
+        connectAction(Action::ToggleOnAllDesktops);
         QObject::connect(settings.data(), &DecorationSettings::onAllDesktopsAvailableChanged, q, &DecorationButton::setVisible);
         QObject::connect(c, &DecoratedClient::onAllDesktopsChanged, q, &DecorationButton::setChecked);
         break;
     case DecorationButtonType::Minimize:
         setEnabled(c->isMinimizeable());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestMinimize, Qt::QueuedConnection);
+        connectAction(Action::Minimize);
         QObject::connect(c, &DecoratedClient::minimizeableChanged, q, &DecorationButton::setEnabled);
         break;
     case DecorationButtonType::Maximize:
@@ -111,37 +157,37 @@ void DecorationButton::Private::init()
         setCheckable(true);
         setChecked(c->isMaximized());
         setAcceptedButtons(Qt::LeftButton | Qt::MiddleButton | Qt::RightButton);
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestToggleMaximization, Qt::QueuedConnection);
+        connectAction(Action::ToggleMaximization);
         QObject::connect(c, &DecoratedClient::maximizeableChanged, q, &DecorationButton::setEnabled);
         QObject::connect(c, &DecoratedClient::maximizedChanged, q, &DecorationButton::setChecked);
         break;
     case DecorationButtonType::Close:
         setEnabled(c->isCloseable());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestClose, Qt::QueuedConnection);
+        connectAction(Action::Close);
         QObject::connect(c, &DecoratedClient::closeableChanged, q, &DecorationButton::setEnabled);
         break;
     case DecorationButtonType::ContextHelp:
         setVisible(c->providesContextHelp());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestContextHelp, Qt::QueuedConnection);
+        connectAction(Action::ContextHelp);
         QObject::connect(c, &DecoratedClient::providesContextHelpChanged, q, &DecorationButton::setVisible);
         break;
     case DecorationButtonType::KeepAbove:
         setCheckable(true);
         setChecked(c->isKeepAbove());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestToggleKeepAbove, Qt::QueuedConnection);
+        connectAction(Action::ToggleKeepAbove);
         QObject::connect(c, &DecoratedClient::keepAboveChanged, q, &DecorationButton::setChecked);
         break;
     case DecorationButtonType::KeepBelow:
         setCheckable(true);
         setChecked(c->isKeepBelow());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestToggleKeepBelow, Qt::QueuedConnection);
+        connectAction(Action::ToggleKeepBelow);
         QObject::connect(c, &DecoratedClient::keepBelowChanged, q, &DecorationButton::setChecked);
         break;
     case DecorationButtonType::Shade:
         setEnabled(c->isShadeable());
         setCheckable(true);
         setChecked(c->isShaded());
-        QObject::connect(q, &DecorationButton::clicked, decoration.data(), &Decoration::requestToggleShade, Qt::QueuedConnection);
+        connectAction(Action::ToggleShade);
         QObject::connect(c, &DecoratedClient::shadedChanged, q, &DecorationButton::setChecked);
         QObject::connect(c, &DecoratedClient::shadeableChanged, q, &DecorationButton::setEnabled);
         break;
@@ -151,26 +197,36 @@ void DecorationButton::Private::init()
     }
 }
 
+void DecorationButton::Private::setState(StateFlag flag, bool set)
+{
+    if (set) {
+        state |= flag;
+    } else {
+        state &= ~flag;
+    }
+}
+
 void DecorationButton::Private::setHovered(bool set)
 {
-    if (hovered == set) {
+    if (isHovered() == set) {
         return;
     }
-    hovered = set;
-    emit q->hoveredChanged(hovered);
+    setState(Hovered, set);
+    emit q->hoveredChanged(set);
 }
 
 void DecorationButton::Private::setEnabled(bool set)
 {
-    if (enabled == set) {
+    if (isEnabled() == set) {
         return;
     }
-    enabled = set;
-    emit q->enabledChanged(enabled);
-    if (!enabled) {
+    setState(Enabled, set);
+    emit q->enabledChanged(set);
+    if (!set) {
         setHovered(false);
         if (isPressed()) {
             m_pressed = Qt::NoButton;
+            setState(Pressed, false);
             emit q->pressedChanged(false);
         }
     }
@@ -178,15 +234,16 @@ void DecorationButton::Private::setEnabled(bool set)
 
 void DecorationButton::Private::setVisible(bool set)
 {
-    if (visible == set) {
+    if (isVisible() == set) {
         return;
     }
-    visible = set;
+    setState(Visible, set);
     emit q->visibilityChanged(set);
-    if (!visible) {
+    if (!set) {
         setHovered(false);
         if (isPressed()) {
             m_pressed = Qt::NoButton;
+            setState(Pressed, false);
             emit q->pressedChanged(false);
         }
     }
@@ -194,23 +251,23 @@ void DecorationButton::Private::setVisible(bool set)
 
 void DecorationButton::Private::setChecked(bool set)
 {
-    if (!checkable || checked == set) {
+    if (!isCheckable() || isChecked() == set) {
         return;
     }
-    checked = set;
-    emit q->checkedChanged(checked);
+    setState(Checked, set);
+    emit q->checkedChanged(set);
 }
 
 void DecorationButton::Private::setCheckable(bool set)
 {
-    if (checkable == set) {
+    if (isCheckable() == set) {
         return;
     }
     if (!set) {
         setChecked(false);
     }
-    checkable = set;
-    emit q->checkableChanged(checkable);
+    setState(Checkable, set);
+    emit q->checkableChanged(set);
 }
 
 void DecorationButton::Private::setPressed(Qt::MouseButton button, bool pressed)
@@ -220,6 +277,7 @@ void DecorationButton::Private::setPressed(Qt::MouseButton button, bool pressed)
     } else {
         m_pressed = m_pressed & ~button;
     }
+    setState(Pressed, isPressed());
     emit q->pressedChanged(isPressed());
 }
 
@@ -232,67 +290,84 @@ void DecorationButton::Private::setAcceptedButtons(Qt::MouseButtons buttons)
     emit q->acceptedButtonsChanged(acceptedButtons);
 }
 
-void DecorationButton::Private::startDoubleClickTimer()
+void DecorationButton::Private::setDoubleClickEnabled(bool enabled)
 {
-    if (!doubleClickEnabled) {
-        return;
-    }
-    if (m_doubleClickTimer.isNull()) {
-        m_doubleClickTimer.reset(new QElapsedTimer());
+    setState(DoubleClickEnabled, enabled);
+    if (!enabled) {
+        invalidateDoubleClick();
     }
-    m_doubleClickTimer->start();
 }
 
-void DecorationButton::Private::invalidateDoubleClickTimer()
+void DecorationButton::Private::startDoubleClick(ulong timestamp)
 {
-    if (m_doubleClickTimer.isNull()) {
+    if (!isDoubleClickEnabled()) {
         return;
     }
-    m_doubleClickTimer->invalidate();
+    // only synthesized events without a timestamp need to read the clock
+    m_lastReleaseSynthesized = timestamp == 0;
+    m_lastRelease = m_lastReleaseSynthesized ? DecorationTimerService::now() : qint64(timestamp);
+}
+
+void DecorationButton::Private::invalidateDoubleClick()
+{
+    m_lastRelease = -1;
 }
 
-bool DecorationButton::Private::wasDoubleClick() const
+bool DecorationButton::Private::wasDoubleClick(ulong timestamp) const
 {
-    if (m_doubleClickTimer.isNull() || !m_doubleClickTimer->isValid()) {
+    if (m_lastRelease < 0 || m_lastReleaseSynthesized != (timestamp == 0)) {
+        return false;
+    }
+    const qint64 time = m_lastReleaseSynthesized ? DecorationTimerService::now() : qint64(timestamp);
+    if (time < m_lastRelease) {
         return false;
     }
-    return !m_doubleClickTimer->hasExpired(QGuiApplication::styleHints()->mouseDoubleClickInterval());
+    return time - m_lastRelease <= s_styleHints.doubleClickInterval();
 }
 
 void DecorationButton::Private::setPressAndHold(bool enable)
 {
-    if (pressAndHold == enable) {
+    if (isPressAndHold() == enable) {
         return;
     }
-    pressAndHold = enable;
-    if (!pressAndHold) {
-        m_pressAndHoldTimer.reset();
+    setState(PressAndHold, enable);
+    if (!enable) {
+        stopPressAndHold();
     }
 }
 
 void DecorationButton::Private::startPressAndHold()
 {
-    if (!pressAndHold) {
+    if (!isPressAndHold() || !decoration) {
         return;
     }
-    if (m_pressAndHoldTimer.isNull()) {
-        m_pressAndHoldTimer.reset(new QTimer());
-        m_pressAndHoldTimer->setSingleShot(true);
-        QObject::connect(m_pressAndHoldTimer.data(), &QTimer::timeout, q, [this]() {
-            q->clicked(Qt::LeftButton);
-        });
-    }
-    m_pressAndHoldTimer->start(QGuiApplication::styleHints()->mousePressAndHoldInterval());
+    decoration->d->timers.schedule(this, s_styleHints.pressAndHoldInterval(), [this] {
+        emit q->clicked(Qt::LeftButton);
+    });
 }
 
 void DecorationButton::Private::stopPressAndHold()
 {
-    if (!m_pressAndHoldTimer.isNull()) {
-        m_pressAndHoldTimer->stop();
+    if (decoration) {
+        decoration->d->timers.cancel(this);
     }
 }
 
-QString DecorationButton::Private::typeToString(DecorationButtonType type)
+void DecorationButton::Private::resetInputState()
+{
+    setHovered(false);
+    if (isPressed()) {
+        m_pressed = Qt::NoButton;
+        setState(Pressed, false);
+        emit q->pressedChanged(false);
+    }
+    stopPressAndHold();
+    invalidateDoubleClick();
+}
+
+namespace
+{
+QString buildToolTip(DecorationButtonType type, bool checked)
 {
     switch (type) {
     case DecorationButtonType::Menu:
@@ -300,14 +375,14 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     case DecorationButtonType::ApplicationMenu:
         return i18n("Application menu");
     case DecorationButtonType::OnAllDesktops:
-        if (this->q->isChecked())
+        if (checked)
             return i18n("On one desktop");
         else
             return i18n("On all desktops");
     case DecorationButtonType::Minimize:
         return i18n("Minimize");
     case DecorationButtonType::Maximize:
-        if (this->q->isChecked())
+        if (checked)
             return i18n("Restore");
         else
             return i18n("Maximize");
@@ -316,17 +391,17 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     case DecorationButtonType::ContextHelp:
         return i18n("Context help");
     case DecorationButtonType::Shade:
-        if (this->q->isChecked())
+        if (checked)
             return i18n("Unshade");
         else
             return i18n("Shade");
     case DecorationButtonType::KeepBelow:
-        if (this->q->isChecked())
+        if (checked)
             return i18n("Don't keep below other windows");
         else
             return i18n("Keep below other windows");
     case DecorationButtonType::KeepAbove:
-        if (this->q->isChecked())
+        if (checked)
             return i18n("Don't keep above other windows");
         else
             return i18n("Keep above other windows");
@@ -335,6 +410,79 @@ QString DecorationButton::Private::typeToString(DecorationButtonType type)
     }
 }
 
+// bumped on the application's thread whenever the language or locale changes
+QAtomicInt s_languageGeneration;
+
+/**
+ * Installed on the QCoreApplication, lives on its thread and is deleted with it.
+ **/
+class LanguageChangeFilter : public QObject
+{
+public:
+    using QObject::QObject;
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        Q_UNUSED(watched)
+        if (event->type() == QEvent::LanguageChange || event->type() == QEvent::LocaleChange) {
+            s_languageGeneration.ref();
+        }
+        return false;
+    }
+};
+
+/**
+ * Tooltip texts for all button types in the checked and unchecked state.
+ * The table is built once and only rebuilt after the application got a
+ * LanguageChange or LocaleChange event, so hovering buttons does not go
+ * through the translation system. Decorations can live on other threads
+ * than the application, so the table is guarded by a mutex.
+ **/
+class ToolTipStrings
+{
+public:
+    QString text(DecorationButtonType type, bool checked)
+    {
+        QMutexLocker locker(&m_mutex);
+        // the application might have been recreated, e.g. between tests
+        QCoreApplication *application = QCoreApplication::instance();
+        if (m_application != application) {
+            m_application = application;
+            m_generation = -1;
+            if (application) {
+                // the filter has to be created on the application's thread
+                QMetaObject::invokeMethod(application, [application] {
+                    application->installEventFilter(new LanguageChangeFilter(application));
+                });
+            }
+        }
+        const int generation = s_languageGeneration.loadAcquire();
+        if (generation != m_generation) {
+            for (int i = 0; i < s_typeCount; ++i) {
+                m_strings[i][0] = buildToolTip(DecorationButtonType(i), false);
+                m_strings[i][1] = buildToolTip(DecorationButtonType(i), true);
+            }
+            m_generation = generation;
+        }
+        return m_strings[int(type)][checked ? 1 : 0];
+    }
+
+private:
+    static constexpr int s_typeCount = int(DecorationButtonType::Custom) + 1;
+    QMutex m_mutex;
+    QString m_strings[s_typeCount][2];
+    QPointer<QCoreApplication> m_application;
+    int m_generation = -1;
+};
+
+Q_GLOBAL_STATIC(ToolTipStrings, s_toolTipStrings)
+
+}
+
+QString DecorationButton::Private::typeToString(DecorationButtonType type)
+{
+    return s_toolTipStrings->text(type, q->isChecked());
+}
+
 DecorationButton::DecorationButton(DecorationButtonType type, const QPointer<Decoration> &decoration, QObject *parent)
     : QObject(parent)
     , d(new Private(type, decoration, this))
@@ -376,7 +524,7 @@ DecorationButton::~DecorationButton() = default;
 
 void DecorationButton::update(const QRectF &rect)
 {
-    decoration()->update(rect.isNull() ? geometry().toRect() : rect.toRect());
+    decoration()->d->damage(rect.isNull() ? geometry() : rect);
 }
 
 void DecorationButton::update()
@@ -400,11 +548,11 @@ bool DecorationButton::isPressed() const
         return d->variableName;                                                                                                                                \
     }
 
-DELEGATE(isHovered, hovered, bool)
-DELEGATE(isEnabled, enabled, bool)
-DELEGATE(isChecked, checked, bool)
-DELEGATE(isCheckable, checkable, bool)
-DELEGATE(isVisible, visible, bool)
+DELEGATE(isHovered, isHovered(), bool)
+DELEGATE(isEnabled, isEnabled(), bool)
+DELEGATE(isChecked, isChecked(), bool)
+DELEGATE(isCheckable, isCheckable(), bool)
+DELEGATE(isVisible, isVisible(), bool)
 
 #define DELEGATE2(name, type) DELEGATE(name, name, type)
 DELEGATE2(geometry, QRectF)
@@ -429,19 +577,14 @@ DELEGATE(setVisible, bool)
 
 #undef DELEGATE
 
-#define DELEGATE(name, variableName, type)                                                                                                                     \
-    void DecorationButton::name(type a)                                                                                                                        \
-    {                                                                                                                                                          \
-        if (d->variableName == a) {                                                                                                                            \
-            return;                                                                                                                                            \
-        }                                                                                                                                                      \
-        d->variableName = a;                                                                                                                                   \
-        emit variableName##Changed(d->variableName);                                                                                                           \
+void DecorationButton::setGeometry(const QRectF &geometry)
+{
+    if (d->geometry == geometry) {
+        return;
     }
-
-DELEGATE(setGeometry, geometry, const QRectF &)
-
-#undef DELEGATE
+    d->geometry = geometry;
+    emit geometryChanged(d->geometry);
+}
 
 bool DecorationButton::contains(const QPointF &pos) const
 {
@@ -450,6 +593,7 @@ bool DecorationButton::contains(const QPointF &pos) const
 
 bool DecorationButton::event(QEvent *event)
 {
+    KDECORATION2_TRACE_SCOPE("DecorationButton::event");
     switch (event->type()) {
     case QEvent::HoverEnter:
         hoverEnterEvent(static_cast<QHoverEvent *>(event));
@@ -479,7 +623,7 @@ bool DecorationButton::event(QEvent *event)
 
 void DecorationButton::hoverEnterEvent(QHoverEvent *event)
 {
-    if (!d->enabled || !d->visible || !contains(event->posF())) {
+    if (!d->isEnabled() || !d->isVisible() || !contains(event->posF())) {
         return;
     }
     d->setHovered(true);
@@ -488,7 +632,7 @@ void DecorationButton::hoverEnterEvent(QHoverEvent *event)
 
 void DecorationButton::hoverLeaveEvent(QHoverEvent *event)
 {
-    if (!d->enabled || !d->visible || !d->hovered || contains(event->posF())) {
+    if (!d->isEnabled() || !d->isVisible() || !d->isHovered() || contains(event->posF())) {
         return;
     }
     d->setHovered(false);
@@ -502,7 +646,7 @@ void DecorationButton::hoverMoveEvent(QHoverEvent *event)
 
 void DecorationButton::mouseMoveEvent(QMouseEvent *event)
 {
-    if (!d->enabled || !d->visible || !d->hovered) {
+    if (!d->isEnabled() || !d->isVisible() || !d->isHovered()) {
         return;
     }
     if (!contains(event->localPos())) {
@@ -513,31 +657,31 @@ void DecorationButton::mouseMoveEvent(QMouseEvent *event)
 
 void DecorationButton::mousePressEvent(QMouseEvent *event)
 {
-    if (!d->enabled || !d->visible || !contains(event->localPos()) || !d->acceptedButtons.testFlag(event->button())) {
+    if (!d->isEnabled() || !d->isVisible() || !contains(event->localPos()) || !d->acceptedButtons.testFlag(event->button())) {
         return;
     }
     d->setPressed(event->button(), true);
     event->setAccepted(true);
-    if (d->doubleClickEnabled && event->button() == Qt::LeftButton) {
+    if (d->isDoubleClickEnabled() && event->button() == Qt::LeftButton) {
         // check for double click
-        if (d->wasDoubleClick()) {
+        if (d->wasDoubleClick(event->timestamp())) {
             event->setAccepted(true);
             emit doubleClicked();
         }
-        d->invalidateDoubleClickTimer();
+        d->invalidateDoubleClick();
     }
-    if (d->pressAndHold && event->button() == Qt::LeftButton) {
+    if (d->isPressAndHold() && event->button() == Qt::LeftButton) {
         d->startPressAndHold();
     }
 }
 
 void DecorationButton::mouseReleaseEvent(QMouseEvent *event)
 {
-    if (!d->enabled || !d->visible || !d->isPressed(event->button())) {
+    if (!d->isEnabled() || !d->isVisible() || !d->isPressed(event->button())) {
         return;
     }
     if (contains(event->localPos())) {
-        if (!d->pressAndHold || event->button() != Qt::LeftButton) {
+        if (!d->isPressAndHold() || event->button() != Qt::LeftButton) {
             emit clicked(event->button());
         } else {
             d->stopPressAndHold();
@@ -546,8 +690,8 @@ void DecorationButton::mouseReleaseEvent(QMouseEvent *event)
     d->setPressed(event->button(), false);
     event->setAccepted(true);
 
-    if (d->doubleClickEnabled && event->button() == Qt::LeftButton) {
-        d->startDoubleClickTimer();
+    if (d->isDoubleClickEnabled() && event->button() == Qt::LeftButton) {
+        d->startDoubleClick(event->timestamp());
     }
 }
 
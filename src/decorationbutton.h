@@ -171,6 +171,8 @@ protected:
     virtual void wheelEvent(QWheelEvent *event);
 
 private:
+    friend class Decoration;
+    friend class DecorationButtonModel;
     class Private;
     QScopedPointer<Private> d;
 };
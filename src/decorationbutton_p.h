@@ -7,9 +7,7 @@
 #define KDECORATION2_DECORATIONBUTTON_P_H
 
 #include "decorationbutton.h"
-
-class QElapsedTimer;
-class QTimer;
+#include "decorationbuttonmodel_p.h"
 
 //
 //  W A R N I N G
@@ -30,6 +28,54 @@ public:
     explicit Private(DecorationButtonType type, const QPointer<Decoration> &decoration, DecorationButton *parent);
     ~Private();
 
+    /**
+     * The lower bits are shared with DecorationButtonModel, so that the
+     * state can be handed to the model without any translation.
+     **/
+    enum StateFlag : quint8 {
+        Hovered = DecorationButtonModel::Hovered,
+        Enabled = DecorationButtonModel::Enabled,
+        Visible = DecorationButtonModel::Visible,
+        Pressed = DecorationButtonModel::Pressed,
+        Checkable = DecorationButtonModel::Checkable,
+        Checked = DecorationButtonModel::Checked,
+        DoubleClickEnabled = 1 << 6,
+        PressAndHold = 1 << 7,
+    };
+    static constexpr quint8 ModelStateMask = Hovered | Enabled | Visible | Pressed | Checkable | Checked;
+
+    bool testState(StateFlag flag) const
+    {
+        return state & flag;
+    }
+    bool isHovered() const
+    {
+        return testState(Hovered);
+    }
+    bool isEnabled() const
+    {
+        return testState(Enabled);
+    }
+    bool isVisible() const
+    {
+        return testState(Visible);
+    }
+    bool isCheckable() const
+    {
+        return testState(Checkable);
+    }
+    bool isChecked() const
+    {
+        return testState(Checked);
+    }
+    bool isDoubleClickEnabled() const
+    {
+        return testState(DoubleClickEnabled);
+    }
+    bool isPressAndHold() const
+    {
+        return testState(PressAndHold);
+    }
     bool isPressed() const
     {
         return m_pressed != Qt::NoButton;
@@ -46,33 +92,50 @@ public:
     void setChecked(bool checked);
     void setCheckable(bool checkable);
     void setVisible(bool visible);
-    void startDoubleClickTimer();
-    void invalidateDoubleClickTimer();
-    bool wasDoubleClick() const;
+    void setDoubleClickEnabled(bool enabled);
+    /**
+     * Remembers the @p timestamp of a left button release for double click detection.
+     * Synthesized events have no timestamp, for them the DecorationTimerService::now
+     * of their delivery is remembered instead.
+     **/
+    void startDoubleClick(ulong timestamp);
+    void invalidateDoubleClick();
+    /**
+     * The press is compared against the release on the clock the release got remembered
+     * with. A press and a release on different clocks are never a double click.
+     **/
+    bool wasDoubleClick(ulong timestamp) const;
     void setPressAndHold(bool enable);
     void startPressAndHold();
     void stopPressAndHold();
+    void resetInputState();
+    /**
+     * The state flags as reported by the Decoration's DecorationButtonModel.
+     **/
+    quint8 modelState() const
+    {
+        return state & ModelStateMask;
+    }
 
     QString typeToString(DecorationButtonType type);
 
-    QPointer<Decoration> decoration;
-    DecorationButtonType type;
+    // Members are ordered so that everything needed for hit testing and
+    // painting, including m_pressed, fits into the first cache line. The
+    // constructor checks the size, add rarely used data out of line.
     QRectF geometry;
-    bool hovered;
-    bool enabled;
-    bool checkable;
-    bool checked;
-    bool visible;
+    DecorationButtonType type;
     Qt::MouseButtons acceptedButtons;
-    bool doubleClickEnabled;
-    bool pressAndHold;
+    QPointer<Decoration> decoration;
+    quint8 state;
 
 private:
     void init();
-    DecorationButton *q;
+    void setState(StateFlag flag, bool set);
+    // whether m_lastRelease is a DecorationTimerService::now instead of an event timestamp
+    bool m_lastReleaseSynthesized;
     Qt::MouseButtons m_pressed;
-    QScopedPointer<QElapsedTimer> m_doubleClickTimer;
-    QScopedPointer<QTimer> m_pressAndHoldTimer;
+    DecorationButton *q;
+    qint64 m_lastRelease;
 };
 
 }
@@ -5,8 +5,12 @@
  */
 #include "decorationbuttongroup.h"
 #include "decoration.h"
+#include "decoration_p.h"
 #include "decorationbuttongroup_p.h"
+#include "decorationcounters_p.h"
 #include "decorationsettings.h"
+#include "decorationtrace_p.h"
+#include "private/decorationsettingsprivate.h"
 
 #include <QDebug>
 
@@ -15,12 +19,77 @@ namespace KDecoration2
 DecorationButtonGroup::Private::Private(Decoration *decoration, DecorationButtonGroup *parent)
     : decoration(decoration)
     , spacing(0.0)
+    , deferred(false)
+    , creatingButtons(false)
+    , layoutPending(false)
     , q(parent)
 {
 }
 
 DecorationButtonGroup::Private::~Private() = default;
 
+void DecorationButtonGroup::Private::init(Position type)
+{
+    auto settings = decoration->settings();
+    auto buttonTypes = [settings, type] {
+        return (type == Position::Left) ? settings->decorationButtonsLeft() : settings->decorationButtonsRight();
+    };
+    createButtons(buttonTypes());
+    QObject::connect(decoration, &Decoration::devicePixelRatioChanged, q, [this] {
+        updateLayout();
+    });
+    // follows the individual signal, Decorations lay out the buttons on the other signals
+    // emitted within the same batch and must find the new buttons
+    auto changed = type == Position::Left ? &DecorationSettings::decorationButtonsLeftChanged : &DecorationSettings::decorationButtonsRightChanged;
+    DecorationSettings *s = settings.data();
+    QObject::connect(s, changed, q, [this, s, buttonTypes] {
+        // within a batch the layout is updated once all settings changed
+        layoutPending = layoutPending || s->d->isUpdating();
+        qDeleteAll(buttons);
+        buttons.clear();
+        createButtons(buttonTypes());
+    });
+    QObject::connect(s, &DecorationSettings::changed, q, [this] {
+        if (layoutPending) {
+            layoutPending = false;
+            updateLayout();
+        }
+    });
+}
+
+void DecorationButtonGroup::Private::createButtons(const QVector<DecorationButtonType> &types)
+{
+    if (deferred) {
+        deferredButtons = types;
+        if (!layoutPending) {
+            updateLayout();
+        }
+        return;
+    }
+    // layout once for all buttons
+    creatingButtons = true;
+    for (DecorationButtonType type : types) {
+        if (DecorationButton *b = buttonCreator(type, decoration, q)) {
+            q->addButton(QPointer<DecorationButton>(b));
+        }
+    }
+    creatingButtons = false;
+    if (!layoutPending) {
+        updateLayout();
+    }
+}
+
+void DecorationButtonGroup::Private::materializeButtons()
+{
+    if (!deferred) {
+        return;
+    }
+    deferred = false;
+    QVector<DecorationButtonType> types;
+    types.swap(deferredButtons);
+    createButtons(types);
+}
+
 void DecorationButtonGroup::Private::setGeometry(const QRectF &geo)
 {
     if (geometry == geo) {
@@ -35,13 +104,30 @@ namespace
 static bool s_layoutRecursion = false;
 }
 
+QRectF DecorationButtonGroup::Private::snap(const QRectF &rect) const
+{
+    if (qFuzzyCompare(decoration->devicePixelRatio(), 1.0)) {
+        return rect;
+    }
+    return decoration->snapToDevicePixels(rect);
+}
+
 void DecorationButtonGroup::Private::updateLayout()
 {
-    if (s_layoutRecursion) {
+    KDECORATION2_TRACE_SCOPE("DecorationButtonGroup::updateLayout");
+    if (s_layoutRecursion || creatingButtons) {
         return;
     }
     s_layoutRecursion = true;
-    const QPointF &pos = geometry.topLeft();
+    Counters::add(Counters::Layouts);
+    if (deferred) {
+        // no buttons yet, assume all of them are visible
+        const int count = deferredButtons.count();
+        const qreal width = count * deferredButtonSize.width() + qMax(0, count - 1) * spacing;
+        setGeometry(snap(QRectF(pos, QSizeF(width, count > 0 ? deferredButtonSize.height() : 0))));
+        s_layoutRecursion = false;
+        return;
+    }
     // first calculate new size
     qreal height = 0;
     qreal width = 0;
@@ -55,19 +141,19 @@ void DecorationButtonGroup::Private::updateLayout()
             width += spacing;
         }
     }
-    setGeometry(QRectF(pos, QSizeF(width, height)));
+    setGeometry(snap(QRectF(pos, QSizeF(width, height))));
 
-    // now position all buttons
+    // now position all buttons, aligned to physical pixels to not get blurry on fractional scales
     qreal position = pos.x();
     const auto &constButtons = buttons;
     for (auto button : constButtons) {
         if (!button->isVisible()) {
             continue;
         }
-        const QSizeF size = button->size();
         // TODO: center
-        button->setGeometry(QRectF(QPointF(position, pos.y()), size));
-        position += size.width() + spacing;
+        const QRectF buttonGeometry = snap(QRectF(QPointF(position, pos.y()), button->size()));
+        button->setGeometry(buttonGeometry);
+        position = buttonGeometry.right() + spacing;
     }
     s_layoutRecursion = false;
 }
@@ -84,22 +170,22 @@ DecorationButtonGroup::DecorationButtonGroup(DecorationButtonGroup::Position typ
     : QObject(parent)
     , d(new Private(parent, this))
 {
-    auto settings = parent->settings();
-    auto createButtons = [=] {
-        const auto &buttons = (type == Position::Left) ? settings->decorationButtonsLeft() : settings->decorationButtonsRight();
-        for (DecorationButtonType type : buttons) {
-            if (DecorationButton *b = buttonCreator(type, parent, this)) {
-                addButton(QPointer<DecorationButton>(b));
-            }
-        }
-    };
-    createButtons();
-    auto changed = type == Position::Left ? &DecorationSettings::decorationButtonsLeftChanged : &DecorationSettings::decorationButtonsRightChanged;
-    connect(settings.data(), changed, this, [this, createButtons] {
-        qDeleteAll(d->buttons);
-        d->buttons.clear();
-        createButtons();
-    });
+    d->buttonCreator = buttonCreator;
+    d->init(type);
+}
+
+DecorationButtonGroup::DecorationButtonGroup(DecorationButtonGroup::Position type,
+                                             Decoration *parent,
+                                             std::function<DecorationButton *(DecorationButtonType, Decoration *, QObject *)> buttonCreator,
+                                             const QSizeF &buttonSize)
+    : QObject(parent)
+    , d(new Private(parent, this))
+{
+    d->buttonCreator = buttonCreator;
+    d->deferred = true;
+    d->deferredButtonSize = buttonSize;
+    parent->d->addDeferredButtonGroup(this);
+    d->init(type);
 }
 
 DecorationButtonGroup::~DecorationButtonGroup() = default;
@@ -116,6 +202,9 @@ QRectF DecorationButtonGroup::geometry() const
 
 bool DecorationButtonGroup::hasButton(DecorationButtonType type) const
 {
+    if (d->deferred) {
+        return d->deferredButtons.contains(type);
+    }
     // TODO: check for deletion of button
     auto it = std::find_if(d->buttons.begin(), d->buttons.end(), [type](const QPointer<DecorationButton> &button) {
         return button->type() == type;
@@ -135,10 +224,12 @@ QPointF DecorationButtonGroup::pos() const
 
 void DecorationButtonGroup::setPos(const QPointF &pos)
 {
-    if (d->geometry.topLeft() == pos) {
+    // the geometry is snapped, compare with the position as set to not lay out again
+    if (d->pos == pos) {
         return;
     }
-    d->setGeometry(QRectF(pos, d->geometry.size()));
+    d->pos = pos;
+    d->setGeometry(d->snap(QRectF(pos, d->geometry.size())));
     d->updateLayout();
 }
 
@@ -155,6 +246,8 @@ void DecorationButtonGroup::setSpacing(qreal spacing)
 void DecorationButtonGroup::addButton(const QPointer<DecorationButton> &button)
 {
     Q_ASSERT(!button.isNull());
+    // keep the order of the deferred buttons
+    d->materializeButtons();
     connect(button.data(), &DecorationButton::visibilityChanged, this, [this]() {
         d->updateLayout();
     });
@@ -167,11 +260,18 @@ void DecorationButtonGroup::addButton(const QPointer<DecorationButton> &button)
 
 QVector<QPointer<DecorationButton>> DecorationButtonGroup::buttons() const
 {
+    d->materializeButtons();
     return d->buttons;
 }
 
 void DecorationButtonGroup::removeButton(DecorationButtonType type)
 {
+    if (d->deferred) {
+        if (d->deferredButtons.removeAll(type) > 0) {
+            d->updateLayout();
+        }
+        return;
+    }
     bool needUpdate = false;
     auto it = d->buttons.begin();
     while (it != d->buttons.end()) {
@@ -206,6 +306,7 @@ void DecorationButtonGroup::removeButton(const QPointer<DecorationButton> &butto
 
 void DecorationButtonGroup::paint(QPainter *painter, const QRect &repaintArea)
 {
+    d->materializeButtons();
     const auto &buttons = d->buttons;
     for (auto button : buttons) {
         if (!button->isVisible()) {
@@ -56,6 +56,19 @@ public:
     explicit DecorationButtonGroup(Position type,
                                    Decoration *parent,
                                    std::function<DecorationButton *(DecorationButtonType, Decoration *, QObject *)> buttonCreator);
+    /**
+     * Creates a DecorationButtonGroup which defers creating its DecorationButtons until they are
+     * needed for the first time: when the DecorationButtonGroup gets painted, when the Decoration
+     * processes a pointer event or when the buttons get queried. Until then only the
+     * DecorationButtonTypes are stored and the layout assumes @p buttonSize for each of them.
+     *
+     * This is useful for windows which get created minimized or on another virtual desktop.
+     * @since 5.22
+     **/
+    explicit DecorationButtonGroup(Position type,
+                                   Decoration *parent,
+                                   std::function<DecorationButton *(DecorationButtonType, Decoration *, QObject *)> buttonCreator,
+                                   const QSizeF &buttonSize);
     explicit DecorationButtonGroup(Decoration *parent);
     ~DecorationButtonGroup() override;
 
@@ -109,6 +122,7 @@ Q_SIGNALS:
     void posChanged(const QPointF &);
 
 private:
+    friend class Decoration;
     class Private;
     QScopedPointer<Private> d;
 };
@@ -31,13 +31,41 @@ public:
     explicit Private(Decoration *decoration, DecorationButtonGroup *parent);
     ~Private();
 
+    void init(Position type);
     void setGeometry(const QRectF &geometry);
     void updateLayout();
+    /**
+     * Aligns @p rect to physical pixels on fractional scales, so that the buttons don't get
+     * blurry. At a devicePixelRatio of @c 1 the layout is not changed.
+     **/
+    QRectF snap(const QRectF &rect) const;
+    void createButtons(const QVector<DecorationButtonType> &types);
+    void materializeButtons();
 
     Decoration *decoration;
     QRectF geometry;
+    /**
+     * The position as set, the geometry might be snapped to physical pixels.
+     **/
+    QPointF pos;
     QVector<QPointer<DecorationButton>> buttons;
     qreal spacing;
+    std::function<DecorationButton *(DecorationButtonType, Decoration *, QObject *)> buttonCreator;
+    /**
+     * Whether creating the buttons is deferred, in that case only the types are known.
+     **/
+    bool deferred;
+    QVector<DecorationButtonType> deferredButtons;
+    QSizeF deferredButtonSize;
+    /**
+     * Whether createButtons is adding buttons, the layout is updated once it is done.
+     **/
+    bool creatingButtons;
+    /**
+     * Whether the buttons got recreated within a batch of setting changes, they are laid out
+     * once with DecorationSettings::changed.
+     **/
+    bool layoutPending;
 
 private:
     DecorationButtonGroup *q;
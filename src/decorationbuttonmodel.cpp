@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationbuttonmodel_p.h"
+#include "decorationbutton.h"
+#include "decorationbutton_p.h"
+
+namespace KDecoration2
+{
+void DecorationButtonModel::add(DecorationButton *button)
+{
+    Q_ASSERT(!contains(button));
+    m_buttons << button;
+}
+
+void DecorationButtonModel::remove(DecorationButton *button)
+{
+    // invoked once the button is destroyed
+    const int index = indexOf(button);
+    if (index == -1) {
+        return;
+    }
+    m_buttons.remove(index);
+    m_removals++;
+}
+
+bool DecorationButtonModel::contains(const DecorationButton *button) const
+{
+    return indexOf(button) != -1;
+}
+
+int DecorationButtonModel::indexOf(const DecorationButton *button) const
+{
+    for (int i = 0; i < m_buttons.count(); ++i) {
+        if (m_buttons.at(i) == button) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+DecorationButtonType DecorationButtonModel::type(int index) const
+{
+    return m_buttons.at(index)->d->type;
+}
+
+quint8 DecorationButtonModel::state(int index) const
+{
+    return m_buttons.at(index)->d->modelState();
+}
+
+bool DecorationButtonModel::accepts(int index, Qt::MouseButton button) const
+{
+    return m_buttons.at(index)->d->acceptedButtons.testFlag(button);
+}
+
+bool DecorationButtonModel::contains(int index, const QPointF &pos) const
+{
+    return m_buttons.at(index)->contains(pos);
+}
+
+int DecorationButtonModel::firstWithState(quint8 flags) const
+{
+    for (int i = 0; i < m_buttons.count(); ++i) {
+        if (testState(i, flags)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATIONBUTTONMODEL_P_H
+#define KDECORATION2_DECORATIONBUTTONMODEL_P_H
+
+#include "decorationdefines.h"
+
+#include <QPointF>
+#include <QVector>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+class DecorationButton;
+
+/**
+ * Compact list of the DecorationButtons of one Decoration.
+ *
+ * The Decoration dispatches pointer events through this model, so that it does not have to
+ * search its children for the buttons. The model only keeps the buttons, their state and
+ * geometry are read from the DecorationButton::Private, which is the only place they are stored.
+ **/
+class Q_DECL_HIDDEN DecorationButtonModel
+{
+public:
+    enum StateFlag : quint8 {
+        Hovered = 1 << 0,
+        Enabled = 1 << 1,
+        Visible = 1 << 2,
+        Pressed = 1 << 3,
+        Checkable = 1 << 4,
+        Checked = 1 << 5,
+    };
+
+    void add(DecorationButton *button);
+    void remove(DecorationButton *button);
+    bool contains(const DecorationButton *button) const;
+
+    int count() const
+    {
+        return m_buttons.count();
+    }
+    const QVector<DecorationButton *> &buttons() const
+    {
+        return m_buttons;
+    }
+    DecorationButton *button(int index) const
+    {
+        return m_buttons.at(index);
+    }
+    DecorationButtonType type(int index) const;
+    /**
+     * The StateFlags of the button at @p index.
+     **/
+    quint8 state(int index) const;
+    bool testState(int index, quint8 flags) const
+    {
+        return (state(index) & flags) == flags;
+    }
+    bool accepts(int index, Qt::MouseButton button) const;
+    /**
+     * Hit tests the fractional geometry of the button at @p index, same as DecorationButton::contains.
+     **/
+    bool contains(int index, const QPointF &pos) const;
+    /**
+     * @returns The index of the first button with all @p flags set or @c -1
+     **/
+    int firstWithState(quint8 flags) const;
+    /**
+     * Invokes @p function with the index of each button. @p function may remove buttons,
+     * e.g. by sending an event, the removed buttons are skipped and all others are visited.
+     * Buttons added by @p function are not visited.
+     **/
+    template<typename Function>
+    void forEach(Function function) const
+    {
+        // shares the data unless a button gets added or removed
+        const QVector<DecorationButton *> buttons = m_buttons;
+        const int removals = m_removals;
+        for (int i = 0; i < buttons.count(); ++i) {
+            const int index = removals == m_removals ? i : indexOf(buttons.at(i));
+            if (index != -1) {
+                function(index);
+            }
+        }
+    }
+
+private:
+    /**
+     * Only compares the pointers, @p button might already be destroyed.
+     **/
+    int indexOf(const DecorationButton *button) const;
+
+    QVector<DecorationButton *> m_buttons;
+    int m_removals = 0;
+};
+
+} // namespace
+
+#endif
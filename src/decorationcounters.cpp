@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationcounters.h"
+#include "decorationcounters_p.h"
+
+namespace KDecoration2
+{
+namespace Counters
+{
+std::atomic<qint64> values[CounterCount] = {};
+}
+
+DecorationCounters::Snapshot DecorationCounters::snapshot()
+{
+    auto value = [](Counters::Counter counter) {
+        return Counters::values[counter].load(std::memory_order_relaxed);
+    };
+    Snapshot snapshot;
+    snapshot.eventsDispatched = value(Counters::EventsDispatched);
+    snapshot.bridgeUpdates = value(Counters::BridgeUpdates);
+    snapshot.pixelsDamaged = value(Counters::PixelsDamaged);
+    snapshot.layouts = value(Counters::Layouts);
+    snapshot.buttonsCreated = value(Counters::ButtonsCreated);
+    snapshot.buttonsDestroyed = value(Counters::ButtonsDestroyed);
+    snapshot.shadowsAlive = value(Counters::ShadowsAlive);
+    snapshot.shadowBytes = value(Counters::ShadowBytes);
+    return snapshot;
+}
+
+QVariantMap DecorationCounters::toVariantMap(const Snapshot &snapshot)
+{
+    return QVariantMap({
+        {QStringLiteral("eventsDispatched"), snapshot.eventsDispatched},
+        {QStringLiteral("bridgeUpdates"), snapshot.bridgeUpdates},
+        {QStringLiteral("pixelsDamaged"), snapshot.pixelsDamaged},
+        {QStringLiteral("layouts"), snapshot.layouts},
+        {QStringLiteral("buttonsCreated"), snapshot.buttonsCreated},
+        {QStringLiteral("buttonsDestroyed"), snapshot.buttonsDestroyed},
+        {QStringLiteral("shadowsAlive"), snapshot.shadowsAlive},
+        {QStringLiteral("shadowBytes"), snapshot.shadowBytes},
+    });
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_COUNTERS_H
+#define KDECORATION2_DECORATION_COUNTERS_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QVariantMap>
+
+namespace KDecoration2
+{
+/**
+ * @brief Process wide counters of the activity of all Decorations.
+ *
+ * The counters are always maintained, each increment is a relaxed atomic addition. A
+ * compositor can take a snapshot periodically and expose it through its debug interface,
+ * the rates follow from the differences between two snapshots.
+ *
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationCounters
+{
+public:
+    struct Snapshot {
+        /**
+         * Input events dispatched to Decorations.
+         **/
+        qint64 eventsDispatched = 0;
+        /**
+         * Updates passed to the DecorationBridge.
+         **/
+        qint64 bridgeUpdates = 0;
+        /**
+         * The sum of the areas of the updates passed to the DecorationBridge, in device pixels.
+         **/
+        qint64 pixelsDamaged = 0;
+        /**
+         * Layouts of DecorationButtonGroups.
+         **/
+        qint64 layouts = 0;
+        qint64 buttonsCreated = 0;
+        qint64 buttonsDestroyed = 0;
+        /**
+         * The number of DecorationShadows currently alive.
+         **/
+        qint64 shadowsAlive = 0;
+        /**
+         * The size of the images of all DecorationShadows currently alive.
+         **/
+        qint64 shadowBytes = 0;
+    };
+
+    /**
+     * The current values. The counters are read one by one, a snapshot taken while
+     * Decorations are active on other threads is not consistent between counters.
+     **/
+    static Snapshot snapshot();
+    /**
+     * The snapshot keyed by the names of the Snapshot members, e.g. for D-Bus.
+     **/
+    static QVariantMap toVariantMap(const Snapshot &snapshot);
+
+private:
+    DecorationCounters() = delete;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_COUNTERS_P_H
+#define KDECORATION2_DECORATION_COUNTERS_P_H
+
+#include <QtGlobal>
+
+#include <atomic>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+namespace Counters
+{
+enum Counter {
+    EventsDispatched,
+    BridgeUpdates,
+    PixelsDamaged,
+    Layouts,
+    ButtonsCreated,
+    ButtonsDestroyed,
+    ShadowsAlive,
+    ShadowBytes,
+    CounterCount,
+};
+
+extern Q_DECL_HIDDEN std::atomic<qint64> values[CounterCount];
+
+/**
+ * Adds @p value, which is negative for gauges going down, to the @p counter.
+ **/
+inline void add(Counter counter, qint64 value = 1)
+{
+    values[counter].fetch_add(value, std::memory_order_relaxed);
+}
+}
+}
+
+#endif
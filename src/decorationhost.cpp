@@ -0,0 +1,557 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationhost.h"
+#include "decoratedclient.h"
+#include "decoration.h"
+#include "decorationhost_p.h"
+#include "decorationsettings.h"
+#include "private/decorationbridge.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace KDecoration2
+{
+namespace HostProtocol
+{
+Channel::Channel(int fd)
+    : m_fd(fd)
+    , m_writeNotifier(new QSocketNotifier(fd, QSocketNotifier::Write))
+{
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+    m_writeNotifier->setEnabled(false);
+}
+
+Channel::~Channel()
+{
+    m_writeNotifier.reset();
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+bool Channel::send(const QByteArray &payload)
+{
+    if (quint32(payload.size()) > MaximumBatchSize) {
+        return false;
+    }
+    const quint32 size = payload.size();
+    m_writeQueue.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    m_writeQueue.append(payload);
+    if (!flush()) {
+        return false;
+    }
+    // a peer which stopped reading must not make us buffer without bounds
+    return pendingBytes() <= MaximumPendingBytes;
+}
+
+bool Channel::flush()
+{
+    while (pendingBytes() > 0) {
+        const ssize_t written = ::send(m_fd, m_writeQueue.constData() + m_writeOffset, pendingBytes(), MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            abort();
+            return false;
+        }
+        m_writeOffset += written;
+        m_bytesWritten += written;
+    }
+    if (pendingBytes() == 0) {
+        m_writeQueue.clear();
+        m_writeOffset = 0;
+    } else if (m_writeOffset > m_writeQueue.size() / 2) {
+        m_writeQueue.remove(0, m_writeOffset);
+        m_writeOffset = 0;
+    }
+    m_writeNotifier->setEnabled(pendingBytes() > 0);
+    return true;
+}
+
+void Channel::abort()
+{
+    m_writeNotifier->setEnabled(false);
+    m_writeQueue.clear();
+    m_writeOffset = 0;
+}
+
+bool Channel::receive(QVector<QByteArray> &batches)
+{
+    bool alive = true;
+    char buffer[16384];
+    // bounded by the largest batch, the rest is read once the batches got dispatched
+    while (m_readBuffer.size() <= int(MaximumBatchSize + sizeof(quint32))) {
+        const ssize_t count = read(m_fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            m_readBuffer.append(buffer, count);
+            continue;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        // the batches received before the other side went away are still valid
+        alive = count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        break;
+    }
+
+    int offset = 0;
+    while (m_readBuffer.size() - offset >= int(sizeof(quint32))) {
+        quint32 size;
+        std::memcpy(&size, m_readBuffer.constData() + offset, sizeof(size));
+        if (size > MaximumBatchSize) {
+            alive = false;
+            break;
+        }
+        if (quint32(m_readBuffer.size() - offset - sizeof(size)) < size) {
+            break;
+        }
+        batches << m_readBuffer.mid(offset + sizeof(size), size);
+        offset += sizeof(size) + size;
+    }
+    m_readBuffer.remove(0, offset);
+    return alive;
+}
+
+bool Channel::waitReadable(int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (true) {
+        const int remaining = timeout < 0 ? -1 : qMax(0, timeout - int(timer.elapsed()));
+        pollfd pfd = {m_fd, short(POLLIN | (pendingBytes() > 0 ? POLLOUT : 0)), 0};
+        const int ready = poll(&pfd, 1, remaining);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return false;
+        }
+        if (pfd.revents & (POLLIN | POLLHUP | POLLERR)) {
+            return true;
+        }
+        // the other side might wait for the rest of a batch before it replies
+        if ((pfd.revents & POLLOUT) && !flush()) {
+            return true;
+        }
+    }
+}
+}
+}
+
+class Q_DECL_HIDDEN DecorationHost::Private : public DecorationBridge
+{
+public:
+    Private(int socket, const Factory &factory, DecorationHost *q);
+    ~Private() override;
+
+    std::unique_ptr<DecoratedClientPrivate> createClient(DecoratedClient *client, Decoration *decoration) override;
+    std::unique_ptr<DecorationSettingsPrivate> settings(DecorationSettings *parent) override;
+    void update(Decoration *decoration, const QRect &geometry) override;
+    void updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale) override;
+
+    void readBatches();
+    bool dispatch(const QByteArray &batch);
+    void createDecoration(quint32 id, const DecorationHostClientState &state);
+    void destroyDecoration(quint32 id);
+    void sendEvent(quint32 id, QEvent *event);
+    void queueRequest(quint32 id, HostProtocol::Request request, const QVariant &argument);
+    void queueDamage(Decoration *decoration, qreal scale, const QRegion &region);
+    void scheduleReply();
+    void sendReply();
+    void handleDisconnect();
+
+    struct Entry {
+        Decoration *decoration = nullptr;
+        RemoteClient *client = nullptr;
+        bool hovered = false;
+        QPointF position;
+        Qt::MouseButtons buttons;
+    };
+    struct Damage {
+        quint32 id;
+        qreal scale;
+        QRegion region;
+    };
+    struct PendingRequest {
+        quint32 id;
+        HostProtocol::Request request;
+        QVariant argument;
+    };
+
+    DecorationHost *q;
+    HostProtocol::Channel channel;
+    Factory factory;
+    QSocketNotifier *notifier;
+    QTimer *replyTimer;
+    QHash<quint32, Entry> entries;
+    QHash<Decoration *, quint32> ids;
+    QSharedPointer<DecorationSettings> decorationSettings;
+    RemoteSettings *remoteSettings = nullptr;
+    DecorationHostSettingsState settingsState;
+    // the Decoration under construction, the DecoratedClient is created by its constructor
+    quint32 creatingId = 0;
+    const DecorationHostClientState *creatingState = nullptr;
+
+    QVector<quint32> dirtyGeometry;
+    QVector<Damage> damage;
+    QVector<PendingRequest> requests;
+    bool frameDone = false;
+    quint32 frameSerial = 0;
+};
+
+DecorationHost::Private::Private(int socket, const Factory &factory, DecorationHost *q)
+    : q(q)
+    , channel(socket)
+    , factory(factory)
+    , notifier(new QSocketNotifier(socket, QSocketNotifier::Read, this))
+    , replyTimer(new QTimer(this))
+{
+    QObject::connect(notifier, &QSocketNotifier::activated, this, [this] {
+        readBatches();
+    });
+    QObject::connect(channel.writeNotifier(), &QSocketNotifier::activated, this, [this] {
+        if (!channel.flush()) {
+            handleDisconnect();
+        }
+    });
+    // zero timers fire in order, the reply includes the deferred actions of the Decorations
+    replyTimer->setSingleShot(true);
+    replyTimer->setInterval(0);
+    QObject::connect(replyTimer, &QTimer::timeout, this, [this] {
+        sendReply();
+    });
+}
+
+DecorationHost::Private::~Private()
+{
+    // the DecoratedClients call back into the bridge
+    const auto decorations = ids.keys();
+    ids.clear();
+    entries.clear();
+    qDeleteAll(decorations);
+}
+
+std::unique_ptr<DecoratedClientPrivate> DecorationHost::Private::createClient(DecoratedClient *client, Decoration *decoration)
+{
+    Q_ASSERT(creatingState);
+    const quint32 id = creatingId;
+    auto remote = std::unique_ptr<RemoteClient>(new RemoteClient(client, decoration, *creatingState, [this, id](HostProtocol::Request request, const QVariant &argument) {
+        queueRequest(id, request, argument);
+    }));
+    entries[id].client = remote.get();
+    return remote;
+}
+
+std::unique_ptr<DecorationSettingsPrivate> DecorationHost::Private::settings(DecorationSettings *parent)
+{
+    auto settings = std::unique_ptr<RemoteSettings>(new RemoteSettings(parent, settingsState));
+    remoteSettings = settings.get();
+    return settings;
+}
+
+void DecorationHost::Private::update(Decoration *decoration, const QRect &geometry)
+{
+    queueDamage(decoration, 1.0, geometry);
+}
+
+void DecorationHost::Private::updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale)
+{
+    queueDamage(decoration, scale, deviceGeometry);
+}
+
+void DecorationHost::Private::readBatches()
+{
+    QVector<QByteArray> batches;
+    const bool alive = channel.receive(batches);
+    for (const QByteArray &batch : qAsConst(batches)) {
+        if (!dispatch(batch)) {
+            handleDisconnect();
+            return;
+        }
+    }
+    if (!alive) {
+        handleDisconnect();
+    }
+}
+
+bool DecorationHost::Private::dispatch(const QByteArray &batch)
+{
+    using HostProtocol::Message;
+    QDataStream stream(batch);
+    stream.setVersion(QDataStream::Qt_5_15);
+    while (!stream.atEnd()) {
+        quint8 message = 0;
+        quint32 id = 0;
+        stream >> message;
+        switch (Message(message)) {
+        case Message::Settings:
+            if (remoteSettings) {
+                remoteSettings->read(stream);
+            } else {
+                HostProtocol::read(stream, settingsState);
+            }
+            break;
+        case Message::CreateDecoration: {
+            DecorationHostClientState state;
+            stream >> id;
+            HostProtocol::read(stream, state);
+            if (stream.status() == QDataStream::Ok && !entries.contains(id)) {
+                createDecoration(id, state);
+            }
+            break;
+        }
+        case Message::ClientState: {
+            stream >> id;
+            const auto it = entries.constFind(id);
+            if (it != entries.constEnd()) {
+                it->client->read(stream);
+            } else {
+                // the Decoration could not be created
+                DecorationHostClientState ignored;
+                HostProtocol::read(stream, ignored);
+            }
+            break;
+        }
+        case Message::DestroyDecoration:
+            stream >> id;
+            destroyDecoration(id);
+            break;
+        case Message::HoverMove: {
+            QPointF position;
+            stream >> id >> position;
+            auto it = entries.find(id);
+            if (it == entries.end()) {
+                break;
+            }
+            if (!it->hovered) {
+                it->hovered = true;
+                QHoverEvent enter(QEvent::HoverEnter, position, position);
+                sendEvent(id, &enter);
+            }
+            const Qt::MouseButtons buttons = it->buttons;
+            QHoverEvent move(QEvent::HoverMove, position, it->position);
+            it->position = position;
+            sendEvent(id, &move);
+            if (buttons != Qt::NoButton) {
+                QMouseEvent drag(QEvent::MouseMove, position, Qt::NoButton, buttons, Qt::NoModifier);
+                sendEvent(id, &drag);
+            }
+            break;
+        }
+        case Message::HoverLeave: {
+            stream >> id;
+            auto it = entries.find(id);
+            if (it == entries.end() || !it->hovered) {
+                break;
+            }
+            it->hovered = false;
+            QHoverEvent leave(QEvent::HoverLeave, QPointF(), it->position);
+            sendEvent(id, &leave);
+            break;
+        }
+        case Message::MousePress:
+        case Message::MouseRelease: {
+            QPointF position;
+            quint32 button = 0;
+            stream >> id >> position >> button;
+            auto it = entries.find(id);
+            if (it == entries.end()) {
+                break;
+            }
+            const bool press = Message(message) == Message::MousePress;
+            it->buttons.setFlag(Qt::MouseButton(button), press);
+            it->position = position;
+            QMouseEvent event(press ? QEvent::MouseButtonPress : QEvent::MouseButtonRelease, position, Qt::MouseButton(button), it->buttons, Qt::NoModifier);
+            sendEvent(id, &event);
+            break;
+        }
+        case Message::Wheel: {
+            QPointF position;
+            QPoint angleDelta;
+            stream >> id >> position >> angleDelta;
+            const auto it = entries.constFind(id);
+            if (it == entries.constEnd()) {
+                break;
+            }
+            QWheelEvent event(position, position, QPoint(), angleDelta, it->buttons, Qt::NoModifier, Qt::NoScrollPhase, false);
+            sendEvent(id, &event);
+            break;
+        }
+        case Message::EndFrame:
+            stream >> frameSerial;
+            frameDone = true;
+            scheduleReply();
+            break;
+        default:
+            return false;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DecorationHost::Private::createDecoration(quint32 id, const DecorationHostClientState &state)
+{
+    if (!decorationSettings) {
+        decorationSettings = QSharedPointer<DecorationSettings>::create(this);
+    }
+    creatingId = id;
+    creatingState = &state;
+    Decoration *decoration = factory(nullptr, QVariantList({QVariantMap({{QStringLiteral("bridge"), QVariant::fromValue<DecorationBridge *>(this)}})}));
+    creatingState = nullptr;
+    if (!decoration) {
+        entries.remove(id);
+        return;
+    }
+    entries[id].decoration = decoration;
+    ids.insert(decoration, id);
+    decoration->setSettings(decorationSettings);
+    decoration->init();
+
+    auto geometryChanged = [this, id] {
+        if (!dirtyGeometry.contains(id)) {
+            dirtyGeometry << id;
+            scheduleReply();
+        }
+    };
+    QObject::connect(decoration, &Decoration::bordersChanged, this, geometryChanged);
+    QObject::connect(decoration, &Decoration::titleBarChanged, this, geometryChanged);
+    QObject::connect(decoration, &Decoration::opaqueChanged, this, geometryChanged);
+    geometryChanged();
+}
+
+void DecorationHost::Private::destroyDecoration(quint32 id)
+{
+    const Entry entry = entries.take(id);
+    if (!entry.decoration) {
+        return;
+    }
+    ids.remove(entry.decoration);
+    dirtyGeometry.removeAll(id);
+    damage.erase(std::remove_if(damage.begin(), damage.end(), [id](const Damage &damage) {
+        return damage.id == id;
+    }), damage.end());
+    delete entry.decoration;
+}
+
+void DecorationHost::Private::sendEvent(quint32 id, QEvent *event)
+{
+    if (Decoration *decoration = entries.value(id).decoration) {
+        QCoreApplication::sendEvent(decoration, event);
+    }
+}
+
+void DecorationHost::Private::queueRequest(quint32 id, HostProtocol::Request request, const QVariant &argument)
+{
+    requests.append({id, request, argument});
+    scheduleReply();
+}
+
+void DecorationHost::Private::queueDamage(Decoration *decoration, qreal scale, const QRegion &region)
+{
+    const auto it = ids.constFind(decoration);
+    if (it == ids.constEnd()) {
+        return;
+    }
+    for (Damage &pending : damage) {
+        if (pending.id == *it && qFuzzyCompare(pending.scale, scale)) {
+            pending.region += region;
+            return;
+        }
+    }
+    damage.append({*it, scale, region});
+    scheduleReply();
+}
+
+void DecorationHost::Private::scheduleReply()
+{
+    if (!replyTimer->isActive()) {
+        replyTimer->start();
+    }
+}
+
+void DecorationHost::Private::sendReply()
+{
+    using HostProtocol::Message;
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    for (quint32 id : qAsConst(dirtyGeometry)) {
+        const Decoration *decoration = entries.value(id).decoration;
+        stream << quint8(Message::Geometry) << id << decoration->borders() << decoration->titleBar() << decoration->isOpaque();
+    }
+    for (const Damage &pending : qAsConst(damage)) {
+        stream << quint8(Message::Damage) << pending.id << pending.scale << pending.region;
+    }
+    for (const PendingRequest &request : qAsConst(requests)) {
+        stream << quint8(Message::Request) << request.id;
+        HostProtocol::writeRequest(stream, request.request, request.argument);
+    }
+    if (frameDone) {
+        stream << quint8(Message::FrameDone) << frameSerial;
+    }
+    dirtyGeometry.clear();
+    damage.clear();
+    requests.clear();
+    frameDone = false;
+    if (!payload.isEmpty() && !channel.send(payload)) {
+        handleDisconnect();
+    }
+}
+
+void DecorationHost::Private::handleDisconnect()
+{
+    if (!notifier->isEnabled()) {
+        return;
+    }
+    notifier->setEnabled(false);
+    channel.abort();
+    replyTimer->stop();
+    const auto decorations = ids.keys();
+    ids.clear();
+    entries.clear();
+    qDeleteAll(decorations);
+    Q_EMIT q->disconnected();
+}
+
+DecorationHost::DecorationHost(int socket, const Factory &factory, QObject *parent)
+    : QObject(parent)
+    , d(new Private(socket, factory, this))
+{
+}
+
+DecorationHost::~DecorationHost() = default;
+
+int DecorationHost::decorationCount() const
+{
+    return d->ids.count();
+}
+
+Decoration *DecorationHost::decoration(quint32 id) const
+{
+    return d->entries.value(id).decoration;
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_HOST_H
+#define KDECORATION2_DECORATION_HOST_H
+
+#include "decorationhoststate.h"
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QVariantList>
+
+#include <functional>
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Runs Decorations on behalf of a compositor in a separate process.
+ *
+ * A decoration plugin loaded into the compositor can stall or crash it. In host mode the
+ * compositor starts a helper process, which creates a DecorationHost for its end of a Unix
+ * socket and runs an event loop. The compositor talks to it through a DecorationHostConnection.
+ *
+ * The DecorationHost acts as the DecorationBridge of the Decorations it creates: it mirrors the
+ * window states and settings sent by the compositor into proxy DecoratedClient and
+ * DecorationSettings backends, dispatches the input events to the Decorations and sends their
+ * borders, title bars, damage and requests back. Everything a Decoration changes while the
+ * event loop processes one frame of the compositor is sent as one batch.
+ *
+ * The pixels are not part of the protocol, the helper process renders into a
+ * DecorationSharedBuffer instead, which is updated without copies.
+ *
+ * @see DecorationHostConnection
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationHost : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Creates a Decoration, e.g. through the KPluginFactory of the decoration plugin.
+     * The @p args need to be passed to the Decoration's constructor.
+     **/
+    using Factory = std::function<Decoration *(QObject *parent, const QVariantList &args)>;
+
+    /**
+     * Serves the compositor connected to @p socket. The DecorationHost takes ownership
+     * of the file descriptor.
+     **/
+    explicit DecorationHost(int socket, const Factory &factory, QObject *parent = nullptr);
+    ~DecorationHost() override;
+
+    int decorationCount() const;
+    /**
+     * The Decoration created for the DecorationHostConnection's @p id.
+     **/
+    Decoration *decoration(quint32 id) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the compositor closed the connection, all Decorations are deleted.
+     **/
+    void disconnected();
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,479 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_HOST_P_H
+#define KDECORATION2_DECORATION_HOST_P_H
+
+#include "decorationhoststate.h"
+#include "private/decoratedclientprivate.h"
+#include "private/decorationsettingsprivate.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QIcon>
+#include <QSocketNotifier>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+/**
+ * The wire format between DecorationHostConnection and DecorationHost.
+ *
+ * Each side sends batches, a batch is a native endian quint32 with the size of the payload
+ * followed by the payload. The payload is a sequence of messages written with QDataStream,
+ * each of them starts with the quint8 Message type, most of them followed by the quint32 id
+ * of the Decoration.
+ **/
+namespace HostProtocol
+{
+enum class Message : quint8 {
+    // compositor to host
+    Settings = 1,
+    CreateDecoration,
+    ClientState,
+    DestroyDecoration,
+    HoverMove,
+    HoverLeave,
+    MousePress,
+    MouseRelease,
+    Wheel,
+    EndFrame,
+    // host to compositor
+    Geometry = 64,
+    Damage,
+    Request,
+    FrameDone,
+};
+
+/**
+ * Same values as DecorationHostConnection::Request.
+ **/
+enum class Request : quint8 {
+    Close,
+    ToggleMaximization,
+    Minimize,
+    ContextHelp,
+    ToggleOnAllDesktops,
+    ToggleShade,
+    ToggleKeepAbove,
+    ToggleKeepBelow,
+    ShowWindowMenu,
+    ShowApplicationMenu,
+    ShowToolTip,
+    HideToolTip,
+};
+
+/**
+ * Bits of the field mask preceding a DecorationHostClientState delta. All booleans which
+ * changed are sent together in one quint32 using the same bits.
+ **/
+enum ClientField : quint32 {
+    Active = 1 << 0,
+    OnAllDesktops = 1 << 1,
+    Shaded = 1 << 2,
+    MaximizedHorizontally = 1 << 3,
+    MaximizedVertically = 1 << 4,
+    KeepAbove = 1 << 5,
+    KeepBelow = 1 << 6,
+    Closeable = 1 << 7,
+    Maximizeable = 1 << 8,
+    Minimizeable = 1 << 9,
+    ProvidesContextHelp = 1 << 10,
+    Modal = 1 << 11,
+    Shadeable = 1 << 12,
+    Moveable = 1 << 13,
+    Resizeable = 1 << 14,
+    HasApplicationMenu = 1 << 15,
+    ApplicationMenuActive = 1 << 16,
+    BooleanFields = (1 << 17) - 1,
+    Caption = 1 << 17,
+    Desktop = 1 << 18,
+    Size = 1 << 19,
+    Palette = 1 << 20,
+    AdjacentScreenEdges = 1 << 21,
+    WindowId = 1 << 22,
+    Colors = 1 << 23,
+    Icon = 1 << 24,
+    AllClientFields = (1 << 25) - 1,
+};
+
+enum SettingsField : quint32 {
+    OnAllDesktopsAvailable = 1 << 0,
+    AlphaChannelSupported = 1 << 1,
+    CloseOnDoubleClickOnMenu = 1 << 2,
+    DecorationButtonsLeft = 1 << 3,
+    DecorationButtonsRight = 1 << 4,
+    Border = 1 << 5,
+    Font = 1 << 6,
+    AllSettingsFields = (1 << 7) - 1,
+};
+
+/**
+ * @returns The ClientFields in which @p state differs from @p previous
+ **/
+quint32 compare(const DecorationHostClientState &previous, const DecorationHostClientState &state);
+quint32 compare(const DecorationHostSettingsState &previous, const DecorationHostSettingsState &state);
+
+/**
+ * Writes the field mask followed by the @p fields of the @p state.
+ **/
+void write(QDataStream &stream, const DecorationHostClientState &state, quint32 fields);
+void write(QDataStream &stream, const DecorationHostSettingsState &state, quint32 fields);
+/**
+ * Applies a delta written by write to the @p state.
+ * @returns The fields contained in the delta
+ **/
+quint32 read(QDataStream &stream, DecorationHostClientState &state);
+quint32 read(QDataStream &stream, DecorationHostSettingsState &state);
+
+/**
+ * Writes the @p request followed by its @p argument in the type the request expects.
+ **/
+void writeRequest(QDataStream &stream, Request request, const QVariant &argument);
+/**
+ * Reads a request written by writeRequest.
+ * @returns @c false if the request is unknown or the stream is corrupt
+ **/
+bool readRequest(QDataStream &stream, Request &request, QVariant &argument);
+
+DecorationHostClientState stateOf(const DecoratedClient *client);
+DecorationHostSettingsState stateOf(const DecorationSettings *settings);
+
+/**
+ * The largest batch a side accepts, the connection is closed on larger ones.
+ **/
+constexpr quint32 MaximumBatchSize = 16 * 1024 * 1024;
+/**
+ * The most bytes queued for a side which does not read, the connection is closed beyond.
+ **/
+constexpr qint64 MaximumPendingBytes = 4 * qint64(MaximumBatchSize);
+
+/**
+ * Sends and receives batches over a socket. The socket is switched to non-blocking mode
+ * and closed on destruction.
+ *
+ * Sending never blocks, what does not fit into the socket buffer is queued and written once
+ * the writeNotifier fires. The owner connects to it and calls flush.
+ **/
+class Q_DECL_HIDDEN Channel
+{
+public:
+    explicit Channel(int fd);
+    ~Channel();
+
+    int fd() const
+    {
+        return m_fd;
+    }
+    QSocketNotifier *writeNotifier() const
+    {
+        return m_writeNotifier.get();
+    }
+    /**
+     * Queues the @p payload as one batch and writes as much as possible without blocking.
+     * @returns @c false if the other side went away or too much data is queued for it
+     **/
+    bool send(const QByteArray &payload);
+    /**
+     * Writes as much of the queued data as possible without blocking.
+     * @returns @c false if the other side went away
+     **/
+    bool flush();
+    /**
+     * Stops writing and discards the queued data.
+     **/
+    void abort();
+    qint64 pendingBytes() const
+    {
+        return m_writeQueue.size() - m_writeOffset;
+    }
+    /**
+     * Reads what is available without blocking and appends the complete batches to @p batches.
+     * @returns @c false if the other side went away or sent a batch larger than MaximumBatchSize
+     **/
+    bool receive(QVector<QByteArray> &batches);
+    /**
+     * Blocks up to @p timeout milliseconds until data is available, writing queued data
+     * meanwhile.
+     **/
+    bool waitReadable(int timeout);
+    qint64 bytesWritten() const
+    {
+        return m_bytesWritten;
+    }
+
+private:
+    int m_fd;
+    std::unique_ptr<QSocketNotifier> m_writeNotifier;
+    QByteArray m_readBuffer;
+    QByteArray m_writeQueue;
+    qsizetype m_writeOffset = 0;
+    qint64 m_bytesWritten = 0;
+};
+
+}
+
+using RequestCallback = std::function<void(HostProtocol::Request request, const QVariant &argument)>;
+
+/**
+ * The backend of a DecoratedClient, which mirrors a DecorationHostClientState sent by the
+ * compositor or read from a trace.
+ **/
+class Q_DECL_HIDDEN RemoteClient : public ApplicationMenuEnabledDecoratedClientPrivate
+{
+public:
+    RemoteClient(DecoratedClient *client, Decoration *decoration, const DecorationHostClientState &state, const RequestCallback &request)
+        : ApplicationMenuEnabledDecoratedClientPrivate(client, decoration)
+        , m_state(state)
+        , m_icon(state.icon)
+        , m_request(request)
+    {
+    }
+
+    /**
+     * Applies a delta sent by the compositor and emits the change signals.
+     **/
+    void read(QDataStream &stream);
+
+    bool isActive() const override
+    {
+        return m_state.active;
+    }
+    QString caption() const override
+    {
+        return m_state.caption;
+    }
+    int desktop() const override
+    {
+        return m_state.desktop;
+    }
+    bool isOnAllDesktops() const override
+    {
+        return m_state.onAllDesktops;
+    }
+    bool isShaded() const override
+    {
+        return m_state.shaded;
+    }
+    QIcon icon() const override
+    {
+        return m_icon;
+    }
+    bool isMaximized() const override
+    {
+        return m_state.maximizedHorizontally && m_state.maximizedVertically;
+    }
+    bool isMaximizedHorizontally() const override
+    {
+        return m_state.maximizedHorizontally;
+    }
+    bool isMaximizedVertically() const override
+    {
+        return m_state.maximizedVertically;
+    }
+    bool isKeepAbove() const override
+    {
+        return m_state.keepAbove;
+    }
+    bool isKeepBelow() const override
+    {
+        return m_state.keepBelow;
+    }
+    bool isCloseable() const override
+    {
+        return m_state.closeable;
+    }
+    bool isMaximizeable() const override
+    {
+        return m_state.maximizeable;
+    }
+    bool isMinimizeable() const override
+    {
+        return m_state.minimizeable;
+    }
+    bool providesContextHelp() const override
+    {
+        return m_state.providesContextHelp;
+    }
+    bool isModal() const override
+    {
+        return m_state.modal;
+    }
+    bool isShadeable() const override
+    {
+        return m_state.shadeable;
+    }
+    bool isMoveable() const override
+    {
+        return m_state.moveable;
+    }
+    bool isResizeable() const override
+    {
+        return m_state.resizeable;
+    }
+    bool hasApplicationMenu() const override
+    {
+        return m_state.hasApplicationMenu;
+    }
+    bool isApplicationMenuActive() const override
+    {
+        return m_state.applicationMenuActive;
+    }
+    WId windowId() const override
+    {
+        return m_state.windowId;
+    }
+    WId decorationId() const override
+    {
+        return 0;
+    }
+    int width() const override
+    {
+        return m_state.size.width();
+    }
+    int height() const override
+    {
+        return m_state.size.height();
+    }
+    QSize size() const override
+    {
+        return m_state.size;
+    }
+    QPalette palette() const override
+    {
+        return m_state.palette;
+    }
+    QColor color(ColorGroup group, ColorRole role) const override
+    {
+        return m_state.colors.value(DecorationHostClientState::colorIndex(group, role));
+    }
+    Qt::Edges adjacentScreenEdges() const override
+    {
+        return m_state.adjacentScreenEdges;
+    }
+
+    void requestShowToolTip(const QString &text) override
+    {
+        m_request(HostProtocol::Request::ShowToolTip, text);
+    }
+    void requestHideToolTip() override
+    {
+        m_request(HostProtocol::Request::HideToolTip, QVariant());
+    }
+    void requestClose() override
+    {
+        m_request(HostProtocol::Request::Close, QVariant());
+    }
+    void requestToggleMaximization(Qt::MouseButtons buttons) override
+    {
+        m_request(HostProtocol::Request::ToggleMaximization, int(buttons));
+    }
+    void requestMinimize() override
+    {
+        m_request(HostProtocol::Request::Minimize, QVariant());
+    }
+    void requestContextHelp() override
+    {
+        m_request(HostProtocol::Request::ContextHelp, QVariant());
+    }
+    void requestToggleOnAllDesktops() override
+    {
+        m_request(HostProtocol::Request::ToggleOnAllDesktops, QVariant());
+    }
+    void requestToggleShade() override
+    {
+        m_request(HostProtocol::Request::ToggleShade, QVariant());
+    }
+    void requestToggleKeepAbove() override
+    {
+        m_request(HostProtocol::Request::ToggleKeepAbove, QVariant());
+    }
+    void requestToggleKeepBelow() override
+    {
+        m_request(HostProtocol::Request::ToggleKeepBelow, QVariant());
+    }
+    void requestShowWindowMenu(const QRect &rect) override
+    {
+        m_request(HostProtocol::Request::ShowWindowMenu, rect);
+    }
+    void showApplicationMenu(int actionId) override
+    {
+        Q_UNUSED(actionId)
+    }
+    void requestShowApplicationMenu(const QRect &rect, int actionId) override
+    {
+        m_request(HostProtocol::Request::ShowApplicationMenu, QVariantList({rect, actionId}));
+    }
+
+private:
+    DecorationHostClientState m_state;
+    QIcon m_icon;
+    RequestCallback m_request;
+};
+
+/**
+ * The backend of a DecorationSettings, which mirrors a DecorationHostSettingsState.
+ **/
+class Q_DECL_HIDDEN RemoteSettings : public DecorationSettingsPrivate
+{
+public:
+    RemoteSettings(DecorationSettings *parent, const DecorationHostSettingsState &state)
+        : DecorationSettingsPrivate(parent)
+        , m_state(state)
+    {
+    }
+
+    void read(QDataStream &stream);
+
+    bool isOnAllDesktopsAvailable() const override
+    {
+        return m_state.onAllDesktopsAvailable;
+    }
+    bool isAlphaChannelSupported() const override
+    {
+        return m_state.alphaChannelSupported;
+    }
+    bool isCloseOnDoubleClickOnMenu() const override
+    {
+        return m_state.closeOnDoubleClickOnMenu;
+    }
+    QVector<DecorationButtonType> decorationButtonsLeft() const override
+    {
+        return m_state.decorationButtonsLeft;
+    }
+    QVector<DecorationButtonType> decorationButtonsRight() const override
+    {
+        return m_state.decorationButtonsRight;
+    }
+    BorderSize borderSize() const override
+    {
+        return m_state.borderSize;
+    }
+    QFont font() const override
+    {
+        return m_state.font;
+    }
+
+private:
+    DecorationHostSettingsState m_state;
+};
+}
+
+#endif
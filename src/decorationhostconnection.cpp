@@ -0,0 +1,356 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationhostconnection.h"
+#include "decorationhost_p.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSocketNotifier>
+
+namespace KDecoration2
+{
+static_assert(int(HostProtocol::Request::HideToolTip) == int(DecorationHostConnection::Request::HideToolTip), "Request values need to match");
+
+class Q_DECL_HIDDEN DecorationHostConnection::Private
+{
+public:
+    Private(int socket, DecorationHostConnection *q);
+
+    void readBatches();
+    bool dispatch(const QByteArray &batch);
+    void handleDisconnect();
+
+    struct Client {
+        DecorationHostClientState state;
+        DecorationHostClientState sentState;
+        bool created = false;
+        QMargins borders;
+        QRect titleBar;
+        bool opaque = false;
+    };
+    struct Event {
+        HostProtocol::Message message;
+        quint32 id;
+        QPointF position;
+        quint32 button;
+        QPoint angleDelta;
+    };
+
+    DecorationHostConnection *q;
+    HostProtocol::Channel channel;
+    QSocketNotifier *notifier;
+    bool connected = true;
+    quint32 nextId = 1;
+    quint32 serial = 0;
+    quint32 lastFrame = 0;
+
+    DecorationHostSettingsState settings;
+    DecorationHostSettingsState sentSettings;
+    bool settingsDirty = true;
+    bool settingsSent = false;
+
+    QHash<quint32, Client> clients;
+    // in order of creation, so that a Decoration is created before it gets events
+    QVector<quint32> dirtyClients;
+    QVector<Event> events;
+    QVector<quint32> destroyed;
+};
+
+DecorationHostConnection::Private::Private(int socket, DecorationHostConnection *q)
+    : q(q)
+    , channel(socket)
+    , notifier(new QSocketNotifier(socket, QSocketNotifier::Read, q))
+{
+    QObject::connect(notifier, &QSocketNotifier::activated, q, [this] {
+        readBatches();
+    });
+    QObject::connect(channel.writeNotifier(), &QSocketNotifier::activated, q, [this] {
+        if (!channel.flush()) {
+            handleDisconnect();
+        }
+    });
+}
+
+void DecorationHostConnection::Private::readBatches()
+{
+    QVector<QByteArray> batches;
+    const bool alive = channel.receive(batches);
+    for (const QByteArray &batch : qAsConst(batches)) {
+        if (!dispatch(batch)) {
+            handleDisconnect();
+            return;
+        }
+    }
+    if (!alive) {
+        handleDisconnect();
+    }
+}
+
+bool DecorationHostConnection::Private::dispatch(const QByteArray &batch)
+{
+    using HostProtocol::Message;
+    QDataStream stream(batch);
+    stream.setVersion(QDataStream::Qt_5_15);
+    while (!stream.atEnd()) {
+        quint8 message = 0;
+        quint32 id = 0;
+        stream >> message;
+        switch (Message(message)) {
+        case Message::Geometry: {
+            QMargins borders;
+            QRect titleBar;
+            bool opaque = false;
+            stream >> id >> borders >> titleBar >> opaque;
+            const auto it = clients.find(id);
+            if (it != clients.end() && stream.status() == QDataStream::Ok) {
+                it->borders = borders;
+                it->titleBar = titleBar;
+                it->opaque = opaque;
+                Q_EMIT q->geometryChanged(id);
+            }
+            break;
+        }
+        case Message::Damage: {
+            qreal scale = 1.0;
+            QRegion region;
+            stream >> id >> scale >> region;
+            if (clients.contains(id) && stream.status() == QDataStream::Ok) {
+                Q_EMIT q->damaged(id, scale, region);
+            }
+            break;
+        }
+        case Message::Request: {
+            HostProtocol::Request request;
+            QVariant argument;
+            stream >> id;
+            // the host is not trusted, only known requests with the expected arguments pass
+            if (!HostProtocol::readRequest(stream, request, argument)) {
+                return false;
+            }
+            if (clients.contains(id)) {
+                Q_EMIT q->requested(id, Request(request), argument);
+            }
+            break;
+        }
+        case Message::FrameDone:
+            stream >> lastFrame;
+            Q_EMIT q->frameDone(lastFrame);
+            break;
+        default:
+            return false;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DecorationHostConnection::Private::handleDisconnect()
+{
+    if (!connected) {
+        return;
+    }
+    connected = false;
+    notifier->setEnabled(false);
+    channel.abort();
+    Q_EMIT q->disconnected();
+}
+
+DecorationHostConnection::DecorationHostConnection(int socket, QObject *parent)
+    : QObject(parent)
+    , d(new Private(socket, this))
+{
+}
+
+DecorationHostConnection::~DecorationHostConnection() = default;
+
+void DecorationHostConnection::setSettings(const DecorationHostSettingsState &settings)
+{
+    d->settings = settings;
+    d->settingsDirty = true;
+}
+
+quint32 DecorationHostConnection::createDecoration(const DecorationHostClientState &state)
+{
+    const quint32 id = d->nextId++;
+    Private::Client &client = d->clients[id];
+    client.state = state;
+    d->dirtyClients << id;
+    return id;
+}
+
+void DecorationHostConnection::setClientState(quint32 id, const DecorationHostClientState &state)
+{
+    const auto it = d->clients.find(id);
+    if (it == d->clients.end()) {
+        return;
+    }
+    it->state = state;
+    if (!d->dirtyClients.contains(id)) {
+        d->dirtyClients << id;
+    }
+}
+
+void DecorationHostConnection::destroyDecoration(quint32 id)
+{
+    const Private::Client client = d->clients.take(id);
+    d->dirtyClients.removeOne(id);
+    if (client.created) {
+        d->destroyed << id;
+    }
+}
+
+void DecorationHostConnection::hoverMove(quint32 id, const QPointF &position)
+{
+    if (!d->clients.contains(id)) {
+        return;
+    }
+    // only the last position of a frame matters
+    if (!d->events.isEmpty()) {
+        Private::Event &last = d->events.last();
+        if (last.message == HostProtocol::Message::HoverMove && last.id == id) {
+            last.position = position;
+            return;
+        }
+    }
+    d->events.append({HostProtocol::Message::HoverMove, id, position, 0, QPoint()});
+}
+
+void DecorationHostConnection::hoverLeave(quint32 id)
+{
+    if (d->clients.contains(id)) {
+        d->events.append({HostProtocol::Message::HoverLeave, id, QPointF(), 0, QPoint()});
+    }
+}
+
+void DecorationHostConnection::mousePress(quint32 id, const QPointF &position, Qt::MouseButton button)
+{
+    if (d->clients.contains(id)) {
+        d->events.append({HostProtocol::Message::MousePress, id, position, quint32(button), QPoint()});
+    }
+}
+
+void DecorationHostConnection::mouseRelease(quint32 id, const QPointF &position, Qt::MouseButton button)
+{
+    if (d->clients.contains(id)) {
+        d->events.append({HostProtocol::Message::MouseRelease, id, position, quint32(button), QPoint()});
+    }
+}
+
+void DecorationHostConnection::wheel(quint32 id, const QPointF &position, const QPoint &angleDelta)
+{
+    if (d->clients.contains(id)) {
+        d->events.append({HostProtocol::Message::Wheel, id, position, 0, angleDelta});
+    }
+}
+
+quint32 DecorationHostConnection::flush()
+{
+    using HostProtocol::Message;
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    if (d->settingsDirty) {
+        const quint32 fields = d->settingsSent ? HostProtocol::compare(d->sentSettings, d->settings) : quint32(HostProtocol::AllSettingsFields);
+        if (fields) {
+            stream << quint8(Message::Settings);
+            HostProtocol::write(stream, d->settings, fields);
+        }
+        d->sentSettings = d->settings;
+        d->settingsDirty = false;
+        d->settingsSent = true;
+    }
+    for (quint32 id : qAsConst(d->dirtyClients)) {
+        Private::Client &client = d->clients[id];
+        if (!client.created) {
+            stream << quint8(Message::CreateDecoration) << id;
+            HostProtocol::write(stream, client.state, HostProtocol::AllClientFields);
+            client.created = true;
+        } else if (const quint32 fields = HostProtocol::compare(client.sentState, client.state)) {
+            stream << quint8(Message::ClientState) << id;
+            HostProtocol::write(stream, client.state, fields);
+        }
+        client.sentState = client.state;
+    }
+    for (const Private::Event &event : qAsConst(d->events)) {
+        stream << quint8(event.message) << event.id;
+        switch (event.message) {
+        case Message::HoverMove:
+            stream << event.position;
+            break;
+        case Message::MousePress:
+        case Message::MouseRelease:
+            stream << event.position << event.button;
+            break;
+        case Message::Wheel:
+            stream << event.position << event.angleDelta;
+            break;
+        default:
+            break;
+        }
+    }
+    for (quint32 id : qAsConst(d->destroyed)) {
+        stream << quint8(Message::DestroyDecoration) << id;
+    }
+    stream << quint8(Message::EndFrame) << ++d->serial;
+    d->dirtyClients.clear();
+    d->events.clear();
+    d->destroyed.clear();
+
+    if (d->connected && !d->channel.send(payload)) {
+        d->handleDisconnect();
+    }
+    return d->serial;
+}
+
+bool DecorationHostConnection::waitForFrame(quint32 serial, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    // serials wrap around
+    while (d->connected && qint32(d->lastFrame - serial) < 0) {
+        const int remaining = timeout < 0 ? -1 : qMax(0, timeout - int(timer.elapsed()));
+        if (!d->channel.waitReadable(remaining)) {
+            return false;
+        }
+        d->readBatches();
+    }
+    return qint32(d->lastFrame - serial) >= 0;
+}
+
+quint32 DecorationHostConnection::lastFrame() const
+{
+    return d->lastFrame;
+}
+
+bool DecorationHostConnection::isConnected() const
+{
+    return d->connected;
+}
+
+qint64 DecorationHostConnection::bytesWritten() const
+{
+    return d->channel.bytesWritten();
+}
+
+QMargins DecorationHostConnection::borders(quint32 id) const
+{
+    return d->clients.value(id).borders;
+}
+
+QRect DecorationHostConnection::titleBar(quint32 id) const
+{
+    return d->clients.value(id).titleBar;
+}
+
+bool DecorationHostConnection::isOpaque(quint32 id) const
+{
+    return d->clients.value(id).opaque;
+}
+
+}
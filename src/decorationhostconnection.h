@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_HOST_CONNECTION_H
+#define KDECORATION2_DECORATION_HOST_CONNECTION_H
+
+#include "decorationhost.h"
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QMargins>
+#include <QObject>
+#include <QPointF>
+#include <QRect>
+#include <QRegion>
+#include <QScopedPointer>
+#include <QVariant>
+
+namespace KDecoration2
+{
+/**
+ * @brief The compositor's end of the connection to a DecorationHost.
+ *
+ * All calls are queued and sent to the DecorationHost as one batch by flush, which the
+ * compositor invokes once per frame. Consecutive hover moves of the same Decoration are
+ * coalesced and window states are sent as deltas against the state sent before.
+ *
+ * The replies of the DecorationHost are processed whenever the event loop runs or
+ * waitForFrame blocks.
+ *
+ * @see DecorationHost
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationHostConnection : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Request {
+        Close,
+        ToggleMaximization,
+        Minimize,
+        ContextHelp,
+        ToggleOnAllDesktops,
+        ToggleShade,
+        ToggleKeepAbove,
+        ToggleKeepBelow,
+        ShowWindowMenu,
+        ShowApplicationMenu,
+        ShowToolTip,
+        HideToolTip,
+    };
+    Q_ENUM(Request)
+
+    /**
+     * Talks to the DecorationHost connected to @p socket. The DecorationHostConnection
+     * takes ownership of the file descriptor.
+     **/
+    explicit DecorationHostConnection(int socket, QObject *parent = nullptr);
+    ~DecorationHostConnection() override;
+
+    void setSettings(const DecorationHostSettingsState &settings);
+    /**
+     * Creates a Decoration for a window in the @p state.
+     * @returns The id of the Decoration
+     **/
+    quint32 createDecoration(const DecorationHostClientState &state);
+    void setClientState(quint32 id, const DecorationHostClientState &state);
+    void destroyDecoration(quint32 id);
+
+    void hoverMove(quint32 id, const QPointF &position);
+    void hoverLeave(quint32 id);
+    void mousePress(quint32 id, const QPointF &position, Qt::MouseButton button);
+    void mouseRelease(quint32 id, const QPointF &position, Qt::MouseButton button);
+    void wheel(quint32 id, const QPointF &position, const QPoint &angleDelta);
+
+    /**
+     * Sends everything queued since the last flush as one batch. This never blocks, what
+     * the socket does not take is written from the event loop. A DecorationHost which stops
+     * reading gets disconnected once too much data is queued for it.
+     * @returns The serial of the frame, which is passed to frameDone once the DecorationHost
+     * processed it
+     **/
+    quint32 flush();
+    /**
+     * Blocks up to @p timeout milliseconds until the DecorationHost processed the frame with
+     * the @p serial, a @p timeout of @c -1 waits forever.
+     **/
+    bool waitForFrame(quint32 serial, int timeout = -1);
+    /**
+     * The serial of the last frame processed by the DecorationHost.
+     **/
+    quint32 lastFrame() const;
+    bool isConnected() const;
+    /**
+     * The number of bytes sent to the DecorationHost so far.
+     **/
+    qint64 bytesWritten() const;
+
+    QMargins borders(quint32 id) const;
+    QRect titleBar(quint32 id) const;
+    bool isOpaque(quint32 id) const;
+
+Q_SIGNALS:
+    void frameDone(quint32 serial);
+    /**
+     * Emitted when the borders, title bar or opaqueness of the Decoration changed.
+     **/
+    void geometryChanged(quint32 id);
+    /**
+     * The @p region is in physical pixels of the @p scale.
+     **/
+    void damaged(quint32 id, qreal scale, const QRegion &region);
+    /**
+     * The @p argument is the Qt::MouseButtons of ToggleMaximization, the QRect of
+     * ShowWindowMenu, the QRect and action id as a QVariantList of ShowApplicationMenu
+     * and the text of ShowToolTip.
+     **/
+    void requested(quint32 id, KDecoration2::DecorationHostConnection::Request request, const QVariant &argument);
+    void disconnected();
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
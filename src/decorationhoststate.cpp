@@ -0,0 +1,472 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationhoststate.h"
+#include "decoratedclient.h"
+#include "decoration.h"
+#include "decorationhost_p.h"
+#include "decorationsettings.h"
+
+#include <QRect>
+
+#include <algorithm>
+
+namespace KDecoration2
+{
+namespace HostProtocol
+{
+namespace
+{
+struct BooleanField {
+    bool DecorationHostClientState::*member;
+    quint32 field;
+};
+
+const BooleanField s_booleanFields[] = {
+    {&DecorationHostClientState::active, Active},
+    {&DecorationHostClientState::onAllDesktops, OnAllDesktops},
+    {&DecorationHostClientState::shaded, Shaded},
+    {&DecorationHostClientState::maximizedHorizontally, MaximizedHorizontally},
+    {&DecorationHostClientState::maximizedVertically, MaximizedVertically},
+    {&DecorationHostClientState::keepAbove, KeepAbove},
+    {&DecorationHostClientState::keepBelow, KeepBelow},
+    {&DecorationHostClientState::closeable, Closeable},
+    {&DecorationHostClientState::maximizeable, Maximizeable},
+    {&DecorationHostClientState::minimizeable, Minimizeable},
+    {&DecorationHostClientState::providesContextHelp, ProvidesContextHelp},
+    {&DecorationHostClientState::modal, Modal},
+    {&DecorationHostClientState::shadeable, Shadeable},
+    {&DecorationHostClientState::moveable, Moveable},
+    {&DecorationHostClientState::resizeable, Resizeable},
+    {&DecorationHostClientState::hasApplicationMenu, HasApplicationMenu},
+    {&DecorationHostClientState::applicationMenuActive, ApplicationMenuActive},
+};
+
+// all combinations of ColorGroup and ColorRole
+const int MaximumColors = 9;
+// the size of the icon in the state of a DecoratedClient
+const int IconSize = 32;
+
+void writeButtons(QDataStream &stream, const QVector<DecorationButtonType> &buttons)
+{
+    stream << quint8(buttons.count());
+    for (DecorationButtonType button : buttons) {
+        stream << quint8(button);
+    }
+}
+
+QVector<DecorationButtonType> readButtons(QDataStream &stream)
+{
+    quint8 count = 0;
+    stream >> count;
+    QVector<DecorationButtonType> buttons;
+    buttons.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        quint8 button = 0;
+        stream >> button;
+        buttons << DecorationButtonType(button);
+    }
+    return buttons;
+}
+}
+
+#define COMPARE(member, field)                                                                                                                                 \
+    if (previous.member != state.member) {                                                                                                                     \
+        fields |= field;                                                                                                                                       \
+    }
+
+quint32 compare(const DecorationHostClientState &previous, const DecorationHostClientState &state)
+{
+    quint32 fields = 0;
+    for (const BooleanField &boolean : s_booleanFields) {
+        if (previous.*boolean.member != state.*boolean.member) {
+            fields |= boolean.field;
+        }
+    }
+    COMPARE(caption, Caption)
+    COMPARE(desktop, Desktop)
+    COMPARE(size, Size)
+    COMPARE(palette, Palette)
+    COMPARE(adjacentScreenEdges, AdjacentScreenEdges)
+    COMPARE(windowId, WindowId)
+    COMPARE(colors, Colors)
+    COMPARE(icon.cacheKey(), Icon)
+    return fields;
+}
+
+quint32 compare(const DecorationHostSettingsState &previous, const DecorationHostSettingsState &state)
+{
+    quint32 fields = 0;
+    COMPARE(onAllDesktopsAvailable, OnAllDesktopsAvailable)
+    COMPARE(alphaChannelSupported, AlphaChannelSupported)
+    COMPARE(closeOnDoubleClickOnMenu, CloseOnDoubleClickOnMenu)
+    COMPARE(decorationButtonsLeft, DecorationButtonsLeft)
+    COMPARE(decorationButtonsRight, DecorationButtonsRight)
+    COMPARE(borderSize, Border)
+    COMPARE(font, Font)
+    return fields;
+}
+
+#undef COMPARE
+
+void write(QDataStream &stream, const DecorationHostClientState &state, quint32 fields)
+{
+    stream << fields;
+    if (fields & BooleanFields) {
+        quint32 values = 0;
+        for (const BooleanField &boolean : s_booleanFields) {
+            if (state.*boolean.member) {
+                values |= boolean.field;
+            }
+        }
+        stream << (values & fields);
+    }
+    if (fields & Caption) {
+        stream << state.caption;
+    }
+    if (fields & Desktop) {
+        stream << qint32(state.desktop);
+    }
+    if (fields & Size) {
+        stream << state.size;
+    }
+    if (fields & Palette) {
+        stream << state.palette;
+    }
+    if (fields & AdjacentScreenEdges) {
+        stream << quint8(state.adjacentScreenEdges);
+    }
+    if (fields & WindowId) {
+        stream << quint64(state.windowId);
+    }
+    if (fields & Colors) {
+        stream << quint8(qMin(state.colors.count(), MaximumColors));
+        for (int i = 0; i < qMin(state.colors.count(), MaximumColors); ++i) {
+            stream << state.colors.at(i);
+        }
+    }
+    if (fields & Icon) {
+        stream << state.icon;
+    }
+}
+
+quint32 read(QDataStream &stream, DecorationHostClientState &state)
+{
+    quint32 fields = 0;
+    stream >> fields;
+    if (fields & BooleanFields) {
+        quint32 values = 0;
+        stream >> values;
+        for (const BooleanField &boolean : s_booleanFields) {
+            if (fields & boolean.field) {
+                state.*boolean.member = values & boolean.field;
+            }
+        }
+    }
+    if (fields & Caption) {
+        stream >> state.caption;
+    }
+    if (fields & Desktop) {
+        qint32 desktop = 0;
+        stream >> desktop;
+        state.desktop = desktop;
+    }
+    if (fields & Size) {
+        stream >> state.size;
+    }
+    if (fields & Palette) {
+        stream >> state.palette;
+    }
+    if (fields & AdjacentScreenEdges) {
+        quint8 edges = 0;
+        stream >> edges;
+        state.adjacentScreenEdges = Qt::Edges(edges);
+    }
+    if (fields & WindowId) {
+        quint64 windowId = 0;
+        stream >> windowId;
+        state.windowId = WId(windowId);
+    }
+    if (fields & Colors) {
+        quint8 count = 0;
+        stream >> count;
+        state.colors.resize(qMin(int(count), MaximumColors));
+        for (int i = 0; i < count; ++i) {
+            QColor color;
+            stream >> color;
+            if (i < MaximumColors) {
+                state.colors[i] = color;
+            }
+        }
+    }
+    if (fields & Icon) {
+        stream >> state.icon;
+    }
+    return fields;
+}
+
+void write(QDataStream &stream, const DecorationHostSettingsState &state, quint32 fields)
+{
+    stream << fields;
+    if (fields & OnAllDesktopsAvailable) {
+        stream << state.onAllDesktopsAvailable;
+    }
+    if (fields & AlphaChannelSupported) {
+        stream << state.alphaChannelSupported;
+    }
+    if (fields & CloseOnDoubleClickOnMenu) {
+        stream << state.closeOnDoubleClickOnMenu;
+    }
+    if (fields & DecorationButtonsLeft) {
+        writeButtons(stream, state.decorationButtonsLeft);
+    }
+    if (fields & DecorationButtonsRight) {
+        writeButtons(stream, state.decorationButtonsRight);
+    }
+    if (fields & Border) {
+        stream << quint8(state.borderSize);
+    }
+    if (fields & Font) {
+        stream << state.font;
+    }
+}
+
+quint32 read(QDataStream &stream, DecorationHostSettingsState &state)
+{
+    quint32 fields = 0;
+    stream >> fields;
+    if (fields & OnAllDesktopsAvailable) {
+        stream >> state.onAllDesktopsAvailable;
+    }
+    if (fields & AlphaChannelSupported) {
+        stream >> state.alphaChannelSupported;
+    }
+    if (fields & CloseOnDoubleClickOnMenu) {
+        stream >> state.closeOnDoubleClickOnMenu;
+    }
+    if (fields & DecorationButtonsLeft) {
+        state.decorationButtonsLeft = readButtons(stream);
+    }
+    if (fields & DecorationButtonsRight) {
+        state.decorationButtonsRight = readButtons(stream);
+    }
+    if (fields & Border) {
+        quint8 borderSize = 0;
+        stream >> borderSize;
+        state.borderSize = BorderSize(borderSize);
+    }
+    if (fields & Font) {
+        stream >> state.font;
+    }
+    return fields;
+}
+
+void writeRequest(QDataStream &stream, Request request, const QVariant &argument)
+{
+    stream << quint8(request);
+    switch (request) {
+    case Request::ToggleMaximization:
+        stream << quint32(argument.toInt());
+        break;
+    case Request::ShowWindowMenu:
+        stream << argument.toRect();
+        break;
+    case Request::ShowApplicationMenu: {
+        const QVariantList list = argument.toList();
+        stream << list.value(0).toRect() << qint32(list.value(1).toInt());
+        break;
+    }
+    case Request::ShowToolTip:
+        stream << argument.toString();
+        break;
+    default:
+        break;
+    }
+}
+
+bool readRequest(QDataStream &stream, Request &request, QVariant &argument)
+{
+    quint8 value = 0;
+    stream >> value;
+    if (value > quint8(Request::HideToolTip)) {
+        return false;
+    }
+    request = Request(value);
+    switch (request) {
+    case Request::ToggleMaximization: {
+        quint32 buttons = 0;
+        stream >> buttons;
+        argument = int(Qt::MouseButtons(buttons) & Qt::AllButtons);
+        break;
+    }
+    case Request::ShowWindowMenu: {
+        QRect rect;
+        stream >> rect;
+        argument = rect;
+        break;
+    }
+    case Request::ShowApplicationMenu: {
+        QRect rect;
+        qint32 actionId = 0;
+        stream >> rect >> actionId;
+        argument = QVariantList({rect, int(actionId)});
+        break;
+    }
+    case Request::ShowToolTip: {
+        QString text;
+        stream >> text;
+        argument = text;
+        break;
+    }
+    default:
+        argument = QVariant();
+        break;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+DecorationHostClientState stateOf(const DecoratedClient *client)
+{
+    DecorationHostClientState state;
+    state.active = client->isActive();
+    state.caption = client->caption();
+    state.desktop = client->desktop();
+    state.onAllDesktops = client->isOnAllDesktops();
+    state.shaded = client->isShaded();
+    state.maximizedHorizontally = client->isMaximizedHorizontally();
+    state.maximizedVertically = client->isMaximizedVertically();
+    state.keepAbove = client->isKeepAbove();
+    state.keepBelow = client->isKeepBelow();
+    state.closeable = client->isCloseable();
+    state.maximizeable = client->isMaximizeable();
+    state.minimizeable = client->isMinimizeable();
+    state.providesContextHelp = client->providesContextHelp();
+    state.modal = client->isModal();
+    state.shadeable = client->isShadeable();
+    state.moveable = client->isMoveable();
+    state.resizeable = client->isResizeable();
+    state.hasApplicationMenu = client->hasApplicationMenu();
+    state.applicationMenuActive = client->isApplicationMenuActive();
+    state.size = client->size();
+    state.palette = client->palette();
+    state.adjacentScreenEdges = client->adjacentScreenEdges();
+    state.windowId = client->windowId();
+    state.colors.resize(MaximumColors);
+    for (ColorGroup group : {ColorGroup::Inactive, ColorGroup::Active, ColorGroup::Warning}) {
+        for (ColorRole role : {ColorRole::Frame, ColorRole::TitleBar, ColorRole::Foreground}) {
+            state.colors[DecorationHostClientState::colorIndex(group, role)] = client->color(group, role);
+        }
+    }
+    // the cached pixmap keeps its cacheKey until the icon changes
+    const Decoration *decoration = client->decoration();
+    const QVector<qreal> scales = decoration ? decoration->scales() : QVector<qreal>();
+    const qreal scale = scales.isEmpty() ? 1.0 : *std::max_element(scales.constBegin(), scales.constEnd());
+    state.icon = client->iconPixmap(QSize(IconSize, IconSize), scale);
+    return state;
+}
+
+DecorationHostSettingsState stateOf(const DecorationSettings *settings)
+{
+    DecorationHostSettingsState state;
+    state.onAllDesktopsAvailable = settings->isOnAllDesktopsAvailable();
+    state.alphaChannelSupported = settings->isAlphaChannelSupported();
+    state.closeOnDoubleClickOnMenu = settings->isCloseOnDoubleClickOnMenu();
+    state.decorationButtonsLeft = settings->decorationButtonsLeft();
+    state.decorationButtonsRight = settings->decorationButtonsRight();
+    state.borderSize = settings->borderSize();
+    state.font = settings->font();
+    return state;
+}
+}
+
+void RemoteClient::read(QDataStream &stream)
+{
+    using namespace HostProtocol;
+    const QSize oldSize = m_state.size;
+    const quint32 fields = HostProtocol::read(stream, m_state);
+    DecoratedClient *c = client();
+
+#define CHANGED(field, signal, value)                                                                                                                          \
+    if (fields & field) {                                                                                                                                      \
+        Q_EMIT c->signal(value);                                                                                                                               \
+    }
+
+    CHANGED(Active, activeChanged, m_state.active)
+    CHANGED(Caption, captionChanged, m_state.caption)
+    CHANGED(Desktop, desktopChanged, m_state.desktop)
+    CHANGED(OnAllDesktops, onAllDesktopsChanged, m_state.onAllDesktops)
+    CHANGED(Shaded, shadedChanged, m_state.shaded)
+    if (fields & (MaximizedHorizontally | MaximizedVertically)) {
+        Q_EMIT c->maximizedChanged(isMaximized());
+    }
+    CHANGED(MaximizedHorizontally, maximizedHorizontallyChanged, m_state.maximizedHorizontally)
+    CHANGED(MaximizedVertically, maximizedVerticallyChanged, m_state.maximizedVertically)
+    CHANGED(KeepAbove, keepAboveChanged, m_state.keepAbove)
+    CHANGED(KeepBelow, keepBelowChanged, m_state.keepBelow)
+    CHANGED(Closeable, closeableChanged, m_state.closeable)
+    CHANGED(Maximizeable, maximizeableChanged, m_state.maximizeable)
+    CHANGED(Minimizeable, minimizeableChanged, m_state.minimizeable)
+    CHANGED(ProvidesContextHelp, providesContextHelpChanged, m_state.providesContextHelp)
+    CHANGED(Shadeable, shadeableChanged, m_state.shadeable)
+    CHANGED(Moveable, moveableChanged, m_state.moveable)
+    CHANGED(Resizeable, resizeableChanged, m_state.resizeable)
+    CHANGED(HasApplicationMenu, hasApplicationMenuChanged, m_state.hasApplicationMenu)
+    CHANGED(ApplicationMenuActive, applicationMenuActiveChanged, m_state.applicationMenuActive)
+    if (fields & Size) {
+        if (oldSize.width() != m_state.size.width()) {
+            Q_EMIT c->widthChanged(m_state.size.width());
+        }
+        if (oldSize.height() != m_state.size.height()) {
+            Q_EMIT c->heightChanged(m_state.size.height());
+        }
+        Q_EMIT c->sizeChanged(m_state.size);
+    }
+    if (fields & (Palette | Colors)) {
+        Q_EMIT c->paletteChanged(m_state.palette);
+    }
+    if (fields & Icon) {
+        m_icon = QIcon(m_state.icon);
+        Q_EMIT c->iconChanged(m_icon);
+    }
+    CHANGED(AdjacentScreenEdges, adjacentScreenEdgesChanged, m_state.adjacentScreenEdges)
+
+#undef CHANGED
+}
+
+void RemoteSettings::read(QDataStream &stream)
+{
+    using namespace HostProtocol;
+    const quint32 fields = HostProtocol::read(stream, m_state);
+    DecorationSettings *s = decorationSettings();
+    // one DecorationSettings::changed for the whole message
+    beginUpdate();
+    if (fields & OnAllDesktopsAvailable) {
+        Q_EMIT s->onAllDesktopsAvailableChanged(m_state.onAllDesktopsAvailable);
+    }
+    if (fields & AlphaChannelSupported) {
+        Q_EMIT s->alphaChannelSupportedChanged(m_state.alphaChannelSupported);
+    }
+    if (fields & CloseOnDoubleClickOnMenu) {
+        Q_EMIT s->closeOnDoubleClickOnMenuChanged(m_state.closeOnDoubleClickOnMenu);
+    }
+    if (fields & DecorationButtonsLeft) {
+        Q_EMIT s->decorationButtonsLeftChanged(m_state.decorationButtonsLeft);
+    }
+    if (fields & DecorationButtonsRight) {
+        Q_EMIT s->decorationButtonsRightChanged(m_state.decorationButtonsRight);
+    }
+    if (fields & Border) {
+        Q_EMIT s->borderSizeChanged(m_state.borderSize);
+    }
+    if (fields & Font) {
+        Q_EMIT s->fontChanged(m_state.font);
+    }
+    if (fields) {
+        Q_EMIT s->reconfigured();
+    }
+    endUpdate();
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_HOST_STATE_H
+#define KDECORATION2_DECORATION_HOST_STATE_H
+
+#include "decorationdefines.h"
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QColor>
+#include <QFont>
+#include <QPalette>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <QtGui/qwindowdefs.h>
+
+namespace KDecoration2
+{
+/**
+ * @brief The state of a window as mirrored into a DecorationHost.
+ *
+ * The DecorationHostConnection only sends the members which changed since the last frame.
+ * A DecorationRecorder writes the same deltas into its traces.
+ *
+ * @since 5.22
+ **/
+struct KDECORATIONS2_EXPORT DecorationHostClientState {
+    bool active = false;
+    QString caption;
+    int desktop = 0;
+    bool onAllDesktops = false;
+    bool shaded = false;
+    bool maximizedHorizontally = false;
+    bool maximizedVertically = false;
+    bool keepAbove = false;
+    bool keepBelow = false;
+    bool closeable = false;
+    bool maximizeable = false;
+    bool minimizeable = false;
+    bool providesContextHelp = false;
+    bool modal = false;
+    bool shadeable = false;
+    bool moveable = false;
+    bool resizeable = false;
+    bool hasApplicationMenu = false;
+    bool applicationMenuActive = false;
+    QSize size;
+    QPalette palette;
+    /**
+     * The colors returned by DecoratedClient::color for a ColorGroup and ColorRole, at the
+     * index colorIndex. Missing entries are invalid colors.
+     **/
+    QVector<QColor> colors;
+    /**
+     * The icon of the window, rendered at the size and scale the Decoration paints it with.
+     * It is compared by QPixmap::cacheKey, keep passing the same pixmap while it does not change.
+     **/
+    QPixmap icon;
+    Qt::Edges adjacentScreenEdges;
+    WId windowId = 0;
+
+    static int colorIndex(ColorGroup group, ColorRole role)
+    {
+        return int(group) * 3 + int(role);
+    }
+};
+
+/**
+ * @brief The DecorationSettings as mirrored into a DecorationHost.
+ *
+ * @since 5.22
+ **/
+struct KDECORATIONS2_EXPORT DecorationHostSettingsState {
+    bool onAllDesktopsAvailable = true;
+    bool alphaChannelSupported = true;
+    bool closeOnDoubleClickOnMenu = false;
+    QVector<DecorationButtonType> decorationButtonsLeft = {DecorationButtonType::Menu, DecorationButtonType::OnAllDesktops};
+    QVector<DecorationButtonType> decorationButtonsRight = {DecorationButtonType::ContextHelp,
+                                                            DecorationButtonType::Minimize,
+                                                            DecorationButtonType::Maximize,
+                                                            DecorationButtonType::Close};
+    BorderSize borderSize = BorderSize::Normal;
+    QFont font;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationrecorder.h"
+#include "decoratedclient.h"
+#include "decoration.h"
+#include "decoration_p.h"
+#include "decorationhost_p.h"
+#include "decorationrecorder_p.h"
+#include "decorationsettings.h"
+
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QPointer>
+
+#include <limits>
+
+namespace KDecoration2
+{
+class Q_DECL_HIDDEN DecorationRecorder::Private
+{
+public:
+    /**
+     * Writes the header of a record.
+     **/
+    void begin(Trace::Record record);
+    void recordClientState();
+    void recordSettings();
+
+    QPointer<Decoration> decoration;
+    QDataStream stream;
+    QElapsedTimer timer;
+    qint64 lastRecord = 0;
+    int count = 0;
+    DecorationHostClientState clientState;
+    DecorationHostSettingsState settingsState;
+};
+
+void DecorationRecorder::Private::begin(Trace::Record record)
+{
+    const qint64 now = timer.nsecsElapsed() / 1000;
+    stream << quint8(record) << quint32(qMin<qint64>(now - lastRecord, std::numeric_limits<quint32>::max()));
+    lastRecord = now;
+    count++;
+}
+
+void DecorationRecorder::Private::recordClientState()
+{
+    const DecorationHostClientState state = HostProtocol::stateOf(decoration->client().toStrongRef().data());
+    if (const quint32 fields = HostProtocol::compare(clientState, state)) {
+        begin(Trace::Record::ClientState);
+        HostProtocol::write(stream, state, fields);
+        clientState = state;
+    }
+}
+
+void DecorationRecorder::Private::recordSettings()
+{
+    const DecorationHostSettingsState state = HostProtocol::stateOf(decoration->settings().data());
+    if (const quint32 fields = HostProtocol::compare(settingsState, state)) {
+        begin(Trace::Record::Settings);
+        HostProtocol::write(stream, state, fields);
+        settingsState = state;
+    }
+}
+
+DecorationRecorder::DecorationRecorder(Decoration *decoration, QIODevice *device, QObject *parent)
+    : QObject(parent)
+    , d(new Private)
+{
+    Q_ASSERT(decoration->settings());
+    d->decoration = decoration;
+    d->stream.setDevice(device);
+    Trace::setup(d->stream);
+    d->stream << Trace::Magic << Trace::Version;
+    d->timer.start();
+
+    const auto client = decoration->client().toStrongRef();
+    const auto settings = decoration->settings();
+    d->settingsState = HostProtocol::stateOf(settings.data());
+    d->begin(Trace::Record::Settings);
+    HostProtocol::write(d->stream, d->settingsState, HostProtocol::AllSettingsFields);
+    d->clientState = HostProtocol::stateOf(client.data());
+    d->begin(Trace::Record::ClientState);
+    HostProtocol::write(d->stream, d->clientState, HostProtocol::AllClientFields);
+
+    // the state is compared, so that changes notified by multiple signals are recorded once
+    auto recordClientState = [this] {
+        d->recordClientState();
+    };
+    connect(client.data(), &DecoratedClient::activeChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::captionChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::desktopChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::onAllDesktopsChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::shadedChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::maximizedHorizontallyChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::maximizedVerticallyChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::keepAboveChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::keepBelowChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::closeableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::maximizeableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::minimizeableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::providesContextHelpChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::shadeableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::moveableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::resizeableChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::widthChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::heightChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::sizeChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::paletteChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::iconChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::adjacentScreenEdgesChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::hasApplicationMenuChanged, this, recordClientState);
+    connect(client.data(), &DecoratedClient::applicationMenuActiveChanged, this, recordClientState);
+
+    auto recordSettings = [this] {
+        d->recordSettings();
+    };
+    connect(settings.data(), &DecorationSettings::onAllDesktopsAvailableChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::alphaChannelSupportedChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::closeOnDoubleClickOnMenuChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::decorationButtonsLeftChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::decorationButtonsRightChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::borderSizeChanged, this, recordSettings);
+    connect(settings.data(), &DecorationSettings::fontChanged, this, recordSettings);
+
+    decoration->installEventFilter(this);
+    decoration->d->damageObserver = [this](const QRect &geometry, qreal scale) {
+        d->begin(Trace::Record::Update);
+        d->stream << geometry << scale;
+    };
+}
+
+DecorationRecorder::~DecorationRecorder()
+{
+    if (d->decoration) {
+        d->decoration->removeEventFilter(this);
+        d->decoration->d->damageObserver = nullptr;
+    }
+}
+
+int DecorationRecorder::recordCount() const
+{
+    return d->count;
+}
+
+bool DecorationRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != d->decoration) {
+        return false;
+    }
+    switch (event->type()) {
+    case QEvent::HoverEnter:
+    case QEvent::HoverMove:
+    case QEvent::HoverLeave: {
+        const auto hoverEvent = static_cast<QHoverEvent *>(event);
+        d->begin(event->type() == QEvent::HoverEnter ? Trace::Record::HoverEnter
+                     : event->type() == QEvent::HoverMove ? Trace::Record::HoverMove
+                                                           : Trace::Record::HoverLeave);
+        d->stream << hoverEvent->posF();
+        break;
+    }
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove: {
+        const auto mouseEvent = static_cast<QMouseEvent *>(event);
+        d->begin(event->type() == QEvent::MouseButtonPress ? Trace::Record::MousePress
+                     : event->type() == QEvent::MouseButtonRelease ? Trace::Record::MouseRelease
+                                                                    : Trace::Record::MouseMove);
+        d->stream << mouseEvent->localPos() << quint32(mouseEvent->button()) << quint32(mouseEvent->buttons());
+        break;
+    }
+    case QEvent::Wheel: {
+        const auto wheelEvent = static_cast<QWheelEvent *>(event);
+        d->begin(Trace::Record::Wheel);
+        d->stream << wheelEvent->position() << wheelEvent->angleDelta() << quint32(wheelEvent->buttons());
+        break;
+    }
+    default:
+        break;
+    }
+    return false;
+}
+
+}
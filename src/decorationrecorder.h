@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_RECORDER_H
+#define KDECORATION2_DECORATION_RECORDER_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QObject>
+#include <QScopedPointer>
+
+class QIODevice;
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Records everything which drives a Decoration into a trace.
+ *
+ * Performance problems like a title bar lagging while the window gets dragged are hard to
+ * reproduce. The DecorationRecorder writes the pointer events dispatched to a Decoration,
+ * the changes of its DecoratedClient and DecorationSettings and the damage it passes to the
+ * DecorationBridge into a compact binary trace. A DecorationReplay drives a Decoration
+ * through the trace again without a compositor.
+ *
+ * Recording stops once the DecorationRecorder or the Decoration gets destroyed.
+ *
+ * @see DecorationReplay
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Starts recording the @p decoration, which needs to be initialized, into the @p device.
+     * The @p device needs to be open for writing and to outlive the DecorationRecorder.
+     **/
+    explicit DecorationRecorder(Decoration *decoration, QIODevice *device, QObject *parent = nullptr);
+    ~DecorationRecorder() override;
+
+    /**
+     * The number of records written so far.
+     **/
+    int recordCount() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
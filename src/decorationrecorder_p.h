@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_RECORDER_P_H
+#define KDECORATION2_DECORATION_RECORDER_P_H
+
+#include <QDataStream>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+/**
+ * The trace written by DecorationRecorder and read by DecorationReplay.
+ *
+ * The trace starts with the Magic and the Version, followed by records. Each record is the
+ * quint8 Record type, a quint32 with the microseconds passed since the previous record and
+ * the payload. Floating point numbers are written in single precision.
+ *
+ * The first two records are always the complete Settings and ClientState, which are
+ * written with the HostProtocol. Later ones only contain the fields which changed.
+ **/
+namespace Trace
+{
+const quint32 Magic = 0x4b445452;
+const quint16 Version = 2;
+
+enum class Record : quint8 {
+    Settings = 1,
+    ClientState,
+    // QPointF position
+    HoverEnter,
+    HoverMove,
+    HoverLeave,
+    // QPointF position, quint32 button, quint32 buttons
+    MousePress,
+    MouseRelease,
+    MouseMove,
+    // QPointF position, QPoint angleDelta, quint32 buttons
+    Wheel,
+    // QRect geometry, qreal scale, the damage passed to the DecorationBridge
+    Update,
+};
+
+inline void setup(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+}
+}
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationrenderscheduler.h"
+#include "decoration.h"
+#include "decoration_p.h"
+#include "decorationsnapshot.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QPainter>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace KDecoration2
+{
+class Q_DECL_HIDDEN DecorationRenderScheduler::Private
+{
+public:
+    explicit Private(DecorationRenderScheduler *parent);
+
+    struct Buffer {
+        qreal scale;
+        // as of the last delivered render job
+        QImage image;
+        // the previously delivered image, the next render job paints into it
+        QImage back;
+        // the area of back which is older than image
+        QRegion stale;
+        bool rendering = false;
+        // scheduled again while rendering
+        bool dirty = false;
+    };
+    /**
+     * Tracks the render jobs of one Decoration, shared between the Entry and its Jobs.
+     **/
+    struct Jobs {
+        QMutex mutex;
+        QWaitCondition finished;
+        int running = 0;
+        // set once the Decoration got removed, jobs which did not start yet skip painting
+        bool cancelled = false;
+    };
+    struct Entry {
+        QVector<Buffer> buffers;
+        QSharedPointer<Jobs> jobs = QSharedPointer<Jobs>::create();
+        Buffer *buffer(qreal scale);
+    };
+    /**
+     * Everything a worker thread needs, the Decoration is only used to invoke paint. The
+     * job is the only one referencing its image, so painting does not detach it.
+     **/
+    struct Job {
+        Decoration *decoration;
+        qreal scale;
+        DecorationSnapshot snapshot;
+        QRegion region;
+        QImage image;
+        QSharedPointer<Jobs> jobs;
+    };
+
+    void dispatch(Decoration *decoration, Entry &entry, Buffer &buffer);
+    /**
+     * Cancels the jobs of @p entry and waits for the ones already painting the Decoration.
+     * Their results get dropped on delivery.
+     **/
+    static void cancel(Entry &entry);
+    static void render(Job &job);
+    /**
+     * Invoked from the thread which rendered the @p job.
+     **/
+    void finish(Job &&job);
+    void deliver();
+
+    QHash<Decoration *, Entry> entries;
+    QThreadPool pool;
+    int pending = 0;
+
+    QMutex finishedMutex;
+    QVector<Job> finished;
+    bool deliveryQueued = false;
+
+private:
+    DecorationRenderScheduler *q;
+};
+
+DecorationRenderScheduler::Private::Private(DecorationRenderScheduler *parent)
+    : q(parent)
+{
+}
+
+DecorationRenderScheduler::Private::Buffer *DecorationRenderScheduler::Private::Entry::buffer(qreal scale)
+{
+    for (Buffer &buffer : buffers) {
+        if (qFuzzyCompare(buffer.scale, scale)) {
+            return &buffer;
+        }
+    }
+    return nullptr;
+}
+
+void DecorationRenderScheduler::Private::dispatch(Decoration *decoration, Entry &entry, Buffer &buffer)
+{
+    if (!decoration->d->renderTarget(buffer.scale)) {
+        // not shown at this scale
+        return;
+    }
+    const QRect deviceRect(QPoint(0, 0), Decoration::Private::toDevicePixels(decoration->rect(), buffer.scale).size());
+    // everything damaged so far is covered by the snapshot
+    QRegion region = decoration->d->takeDamage(buffer.scale, q) & deviceRect;
+    const bool resized = buffer.image.size() != deviceRect.size();
+    if (resized) {
+        region = deviceRect;
+    }
+    if (region.isEmpty()) {
+        return;
+    }
+    QImage image;
+    if (resized) {
+        image = QImage(deviceRect.size(), QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(buffer.scale);
+    } else if (buffer.back.size() == deviceRect.size()) {
+        // bring the previous image up to date with the delivered one as well
+        image = std::move(buffer.back);
+        region |= buffer.stale;
+    } else {
+        // no second back-buffer yet, painting copies the delivered one once
+        image = buffer.image;
+    }
+    buffer.back = QImage();
+    buffer.stale = QRegion();
+
+    buffer.rendering = true;
+    ++pending;
+    {
+        QMutexLocker locker(&entry.jobs->mutex);
+        ++entry.jobs->running;
+    }
+    Job job{decoration, buffer.scale, DecorationSnapshot(decoration), region, std::move(image), entry.jobs};
+    if (decoration->supportsThreadedRendering()) {
+        pool.start([this, job = std::move(job)]() mutable {
+            render(job);
+            finish(std::move(job));
+        });
+    } else {
+        render(job);
+        finish(std::move(job));
+    }
+}
+
+void DecorationRenderScheduler::Private::cancel(Entry &entry)
+{
+    QMutexLocker locker(&entry.jobs->mutex);
+    entry.jobs->cancelled = true;
+    while (entry.jobs->running > 0) {
+        entry.jobs->finished.wait(&entry.jobs->mutex);
+    }
+}
+
+void DecorationRenderScheduler::Private::render(Job &job)
+{
+    {
+        // the job keeps the Decoration from being removed while it paints
+        QMutexLocker locker(&job.jobs->mutex);
+        if (job.jobs->cancelled) {
+            return;
+        }
+    }
+    const QRectF bounds = job.region.boundingRect();
+    const QRect repaintArea = QRectF(bounds.topLeft() / job.scale, bounds.size() / job.scale).toAlignedRect();
+    QPainter painter(&job.image);
+    painter.setClipRect(repaintArea);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(repaintArea, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    job.decoration->d->paint(&painter, repaintArea, job.scale, &job.snapshot);
+    job.region = QRegion(Decoration::Private::toDevicePixels(repaintArea, job.scale)) & job.image.rect();
+}
+
+void DecorationRenderScheduler::Private::finish(Job &&job)
+{
+    const QSharedPointer<Jobs> jobs = job.jobs;
+    {
+        QMutexLocker locker(&finishedMutex);
+        finished.append(std::move(job));
+        if (!deliveryQueued) {
+            deliveryQueued = true;
+            QMetaObject::invokeMethod(
+                q,
+                [this] {
+                    deliver();
+                },
+                Qt::QueuedConnection);
+        }
+    }
+    // from here on the job does not use the Decoration anymore
+    QMutexLocker locker(&jobs->mutex);
+    --jobs->running;
+    jobs->finished.wakeAll();
+}
+
+void DecorationRenderScheduler::Private::deliver()
+{
+    QVector<Job> jobs;
+    {
+        QMutexLocker locker(&finishedMutex);
+        jobs.swap(finished);
+        deliveryQueued = false;
+    }
+    for (Job &job : jobs) {
+        --pending;
+        auto it = entries.find(job.decoration);
+        if (it == entries.end() || it->jobs != job.jobs) {
+            // removed while rendering, maybe scheduled again since
+            continue;
+        }
+        Buffer *buffer = it->buffer(job.scale);
+        if (!buffer) {
+            continue;
+        }
+        buffer->back = std::move(buffer->image);
+        buffer->stale = job.region;
+        buffer->image = std::move(job.image);
+        buffer->rendering = false;
+        const bool dirty = buffer->dirty;
+        buffer->dirty = false;
+        // might remove or schedule the Decoration
+        emit q->rendered(job.decoration, job.scale, job.region);
+        // unless the Decoration got removed or deleted by a slot
+        if (dirty && entries.contains(job.decoration)) {
+            q->schedule(job.decoration, job.scale);
+        }
+    }
+}
+
+DecorationRenderScheduler::DecorationRenderScheduler(QObject *parent)
+    : QObject(parent)
+    , d(new Private(this))
+{
+}
+
+DecorationRenderScheduler::~DecorationRenderScheduler()
+{
+    d->pool.waitForDone();
+    for (auto it = d->entries.cbegin(); it != d->entries.cend(); ++it) {
+        it.key()->d->renderSchedulers.removeOne(this);
+        it.key()->d->releaseDamage(this);
+    }
+}
+
+int DecorationRenderScheduler::maxThreadCount() const
+{
+    return d->pool.maxThreadCount();
+}
+
+void DecorationRenderScheduler::setMaxThreadCount(int count)
+{
+    d->pool.setMaxThreadCount(count);
+}
+
+void DecorationRenderScheduler::schedule(Decoration *decoration, qreal scale)
+{
+    Q_ASSERT(decoration);
+    auto it = d->entries.find(decoration);
+    if (it == d->entries.end()) {
+        it = d->entries.insert(decoration, Private::Entry());
+        // ~Decoration removes the Decoration, while its Private still exists
+        decoration->d->renderSchedulers.append(this);
+    }
+    Private::Buffer *buffer = it->buffer(scale);
+    if (!buffer) {
+        it->buffers.append({scale, QImage(), QImage(), QRegion()});
+        buffer = &it->buffers.last();
+    }
+    if (buffer->rendering) {
+        buffer->dirty = true;
+        return;
+    }
+    d->dispatch(decoration, *it, *buffer);
+}
+
+void DecorationRenderScheduler::remove(Decoration *decoration)
+{
+    auto it = d->entries.find(decoration);
+    if (it == d->entries.end()) {
+        return;
+    }
+    // only waits for the jobs of this Decoration, the queued delivery drops their results
+    Private::cancel(*it);
+    d->entries.erase(it);
+    decoration->d->renderSchedulers.removeOne(this);
+    decoration->d->releaseDamage(this);
+}
+
+QImage DecorationRenderScheduler::image(Decoration *decoration, qreal scale) const
+{
+    auto it = d->entries.find(decoration);
+    if (it == d->entries.end()) {
+        return QImage();
+    }
+    const Private::Buffer *buffer = it->buffer(scale);
+    return buffer ? buffer->image : QImage();
+}
+
+int DecorationRenderScheduler::pendingCount() const
+{
+    return d->pending;
+}
+
+void DecorationRenderScheduler::waitForDone()
+{
+    // delivering can schedule Decorations which got dirty while rendering
+    while (d->pending > 0) {
+        d->pool.waitForDone();
+        d->deliver();
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_RENDER_SCHEDULER_H
+#define KDECORATION2_DECORATION_RENDER_SCHEDULER_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QImage>
+#include <QObject>
+#include <QRegion>
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Renders Decorations into QImage back-buffers on a pool of worker threads.
+ *
+ * After e.g. a change of the color scheme all Decorations need to be repainted at once.
+ * Instead of painting them one after the other on the GUI thread, the framework can schedule
+ * them on a DecorationRenderScheduler. For each scheduled Decoration a DecorationSnapshot is
+ * taken on the GUI thread and the damaged area of the Decoration's back-buffer is repainted
+ * on a worker thread. Once done the back-buffer is handed back to the GUI thread and the
+ * rendered signal is emitted.
+ *
+ * Only Decorations which support threaded rendering are painted on a worker thread, all
+ * others are painted on the GUI thread when they are scheduled. In both cases the result
+ * is delivered from the event loop.
+ *
+ * Deleting a Decoration removes it from the scheduler: ~Decoration cancels its render jobs
+ * which did not start yet and waits for the running ones. As the derived class is already
+ * destroyed at that point, a Decoration supporting threaded rendering which might still be
+ * painted on a worker thread has to be removed before it is deleted.
+ *
+ * Each scheduled scale keeps two back-buffers, the one last delivered and the one the next
+ * render job paints into, so that rendering does not copy the delivered image. Holding on
+ * to a copy of an image makes the render job after the next one copy it, though.
+ *
+ * The scheduler takes the damage of the scheduled scales from the Decoration, so until the
+ * Decoration is removed no DecorationTileBuffer or DecorationSharedBuffer may render it at
+ * the same scales.
+ *
+ * @see Decoration::supportsThreadedRendering
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationRenderScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DecorationRenderScheduler(QObject *parent = nullptr);
+    /**
+     * Waits for all running render jobs.
+     **/
+    ~DecorationRenderScheduler() override;
+
+    /**
+     * The maximum number of worker threads, by default QThread::idealThreadCount.
+     **/
+    int maxThreadCount() const;
+    void setMaxThreadCount(int count);
+
+    /**
+     * Repaints the damaged area of @p decoration at @p scale. If the Decoration is still
+     * being rendered at @p scale it is rendered once more afterwards.
+     *
+     * The @p scale needs to be one of the Decoration's scales.
+     **/
+    void schedule(Decoration *decoration, qreal scale = 1.0);
+    /**
+     * Drops the back-buffers of @p decoration. Blocks until the Decoration's running render
+     * jobs are done, their results are not delivered. Render jobs of other Decorations are
+     * neither waited for nor delivered.
+     **/
+    void remove(Decoration *decoration);
+    /**
+     * The back-buffer of @p decoration at @p scale as of the last time rendered got emitted.
+     * The image's device pixel ratio is @p scale.
+     **/
+    QImage image(Decoration *decoration, qreal scale = 1.0) const;
+    /**
+     * The number of render jobs whose result has not been delivered yet.
+     **/
+    int pendingCount() const;
+    /**
+     * Blocks until all scheduled Decorations are rendered and delivers the results.
+     **/
+    void waitForDone();
+
+Q_SIGNALS:
+    /**
+     * Emitted once the back-buffer of @p decoration at @p scale got repainted. The
+     * @p region is in physical pixels.
+     **/
+    void rendered(KDecoration2::Decoration *decoration, qreal scale, const QRegion &region);
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,286 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationreplay.h"
+#include "decoration.h"
+#include "decorationhost_p.h"
+#include "decorationrecorder_p.h"
+#include "decorationsettings.h"
+#include "private/decorationbridge.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHoverEvent>
+#include <QImage>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+namespace KDecoration2
+{
+class Q_DECL_HIDDEN DecorationReplay::Private : public DecorationBridge
+{
+public:
+    explicit Private(const Factory &factory);
+    ~Private() override;
+
+    std::unique_ptr<DecoratedClientPrivate> createClient(DecoratedClient *client, Decoration *decoration) override;
+    std::unique_ptr<DecorationSettingsPrivate> settings(DecorationSettings *parent) override;
+    void update(Decoration *decoration, const QRect &geometry) override;
+    void updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale) override;
+
+    bool createDecoration(QDataStream &stream);
+    bool dispatch(QDataStream &stream, Trace::Record record);
+    void render();
+    void reset();
+
+    Factory factory;
+    Decoration *decoration = nullptr;
+    RemoteClient *remoteClient = nullptr;
+    RemoteSettings *remoteSettings = nullptr;
+    DecorationHostSettingsState settingsState;
+    DecorationHostClientState clientState;
+    QImage image;
+
+    QVector<qint64> latencies;
+    int bridgeUpdates = 0;
+    int recordedBridgeUpdates = 0;
+};
+
+DecorationReplay::Private::Private(const Factory &factory)
+    : factory(factory)
+{
+}
+
+DecorationReplay::Private::~Private()
+{
+    reset();
+}
+
+void DecorationReplay::Private::reset()
+{
+    // the DecoratedClient calls back into the bridge
+    delete decoration;
+    decoration = nullptr;
+    remoteClient = nullptr;
+    remoteSettings = nullptr;
+    settingsState = DecorationHostSettingsState();
+    latencies.clear();
+    bridgeUpdates = 0;
+    recordedBridgeUpdates = 0;
+}
+
+std::unique_ptr<DecoratedClientPrivate> DecorationReplay::Private::createClient(DecoratedClient *client, Decoration *decoration)
+{
+    // requests of the Decoration have no effect on the recorded window
+    auto remote = std::unique_ptr<RemoteClient>(new RemoteClient(client, decoration, clientState, [](HostProtocol::Request, const QVariant &) {}));
+    remoteClient = remote.get();
+    return remote;
+}
+
+std::unique_ptr<DecorationSettingsPrivate> DecorationReplay::Private::settings(DecorationSettings *parent)
+{
+    auto settings = std::unique_ptr<RemoteSettings>(new RemoteSettings(parent, settingsState));
+    remoteSettings = settings.get();
+    return settings;
+}
+
+void DecorationReplay::Private::update(Decoration *decoration, const QRect &geometry)
+{
+    Q_UNUSED(decoration)
+    Q_UNUSED(geometry)
+    bridgeUpdates++;
+}
+
+void DecorationReplay::Private::updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale)
+{
+    Q_UNUSED(decoration)
+    Q_UNUSED(deviceGeometry)
+    Q_UNUSED(scale)
+    bridgeUpdates++;
+}
+
+bool DecorationReplay::Private::createDecoration(QDataStream &stream)
+{
+    HostProtocol::read(stream, clientState);
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    decoration = factory(nullptr, QVariantList({QVariantMap({{QStringLiteral("bridge"), QVariant::fromValue<DecorationBridge *>(this)}})}));
+    if (!decoration) {
+        return false;
+    }
+    decoration->setSettings(QSharedPointer<DecorationSettings>::create(this));
+    decoration->init();
+    // the Decoration got initialized before the recording started
+    bridgeUpdates = 0;
+    return true;
+}
+
+bool DecorationReplay::Private::dispatch(QDataStream &stream, Trace::Record record)
+{
+    using Trace::Record;
+    switch (record) {
+    case Record::Settings:
+        if (remoteSettings) {
+            remoteSettings->read(stream);
+        } else {
+            HostProtocol::read(stream, settingsState);
+        }
+        break;
+    case Record::ClientState:
+        if (remoteClient) {
+            remoteClient->read(stream);
+        } else if (!createDecoration(stream)) {
+            return false;
+        }
+        break;
+    case Record::HoverEnter:
+    case Record::HoverMove:
+    case Record::HoverLeave: {
+        QPointF position;
+        stream >> position;
+        if (!decoration) {
+            return false;
+        }
+        const QEvent::Type type = record == Record::HoverEnter ? QEvent::HoverEnter : record == Record::HoverMove ? QEvent::HoverMove : QEvent::HoverLeave;
+        QHoverEvent event(type, position, QPointF());
+        QCoreApplication::sendEvent(decoration, &event);
+        break;
+    }
+    case Record::MousePress:
+    case Record::MouseRelease:
+    case Record::MouseMove: {
+        QPointF position;
+        quint32 button = 0;
+        quint32 buttons = 0;
+        stream >> position >> button >> buttons;
+        if (!decoration) {
+            return false;
+        }
+        const QEvent::Type type = record == Record::MousePress ? QEvent::MouseButtonPress
+            : record == Record::MouseRelease                   ? QEvent::MouseButtonRelease
+                                                               : QEvent::MouseMove;
+        QMouseEvent event(type, position, Qt::MouseButton(button), Qt::MouseButtons(buttons), Qt::NoModifier);
+        QCoreApplication::sendEvent(decoration, &event);
+        break;
+    }
+    case Record::Wheel: {
+        QPointF position;
+        QPoint angleDelta;
+        quint32 buttons = 0;
+        stream >> position >> angleDelta >> buttons;
+        if (!decoration) {
+            return false;
+        }
+        QWheelEvent event(position, position, QPoint(), angleDelta, Qt::MouseButtons(buttons), Qt::NoModifier, Qt::NoScrollPhase, false);
+        QCoreApplication::sendEvent(decoration, &event);
+        break;
+    }
+    case Record::Update:
+    default:
+        return false;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+void DecorationReplay::Private::render()
+{
+    if (!decoration) {
+        return;
+    }
+    const QRect rect = decoration->rect();
+    QRect repaintArea = decoration->damage(1.0).boundingRect();
+    if (image.size() != rect.size()) {
+        // the damage is only tracked once rendered
+        image = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        repaintArea = rect;
+    }
+    if (repaintArea.isEmpty()) {
+        return;
+    }
+    QPainter painter(&image);
+    painter.translate(-rect.topLeft());
+    decoration->render(&painter, repaintArea, 1.0);
+}
+
+DecorationReplay::DecorationReplay(const Factory &factory)
+    : d(new Private(factory))
+{
+}
+
+DecorationReplay::~DecorationReplay() = default;
+
+bool DecorationReplay::replay(QIODevice *device)
+{
+    d->reset();
+    QDataStream stream(device);
+    Trace::setup(stream);
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != Trace::Magic || version != Trace::Version) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    while (!stream.atEnd()) {
+        quint8 record = 0;
+        quint32 delay = 0;
+        stream >> record >> delay;
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+        if (Trace::Record(record) == Trace::Record::Update) {
+            QRect geometry;
+            qreal scale;
+            stream >> geometry >> scale;
+            d->recordedBridgeUpdates++;
+            continue;
+        }
+        timer.start();
+        if (!d->dispatch(stream, Trace::Record(record))) {
+            return false;
+        }
+        d->render();
+        d->latencies << timer.nsecsElapsed();
+    }
+    return stream.status() == QDataStream::Ok && d->decoration;
+}
+
+int DecorationReplay::eventCount() const
+{
+    return d->latencies.count();
+}
+
+int DecorationReplay::bridgeUpdates() const
+{
+    return d->bridgeUpdates;
+}
+
+int DecorationReplay::recordedBridgeUpdates() const
+{
+    return d->recordedBridgeUpdates;
+}
+
+qint64 DecorationReplay::latency(qreal percentile) const
+{
+    if (d->latencies.isEmpty()) {
+        return 0;
+    }
+    QVector<qint64> sorted = d->latencies;
+    std::sort(sorted.begin(), sorted.end());
+    // nearest rank
+    const int rank = qBound(1, int(std::ceil(percentile / 100.0 * sorted.count())), sorted.count());
+    return sorted.at(rank - 1);
+}
+
+Decoration *DecorationReplay::decoration() const
+{
+    return d->decoration;
+}
+
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_REPLAY_H
+#define KDECORATION2_DECORATION_REPLAY_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QScopedPointer>
+#include <QVariantList>
+
+#include <functional>
+
+class QIODevice;
+class QObject;
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Drives a Decoration through a trace written by a DecorationRecorder.
+ *
+ * The DecorationReplay acts as the DecorationBridge: it creates the Decoration from the
+ * first recorded window state, applies the recorded changes of the DecoratedClient and the
+ * DecorationSettings, dispatches the recorded pointer events and renders the damage after
+ * each of them into an image, as fast as possible.
+ *
+ * The time needed for dispatching a record and rendering its damage is measured, so that a
+ * performance regression of a decoration plugin shows in the latency percentiles. The number
+ * of updates passed to the DecorationBridge is compared with the recorded one to catch
+ * excessive repaints.
+ *
+ * A replay tool wraps this in a main function, which loads the decoration plugin through
+ * its KPluginFactory.
+ *
+ * @see DecorationRecorder
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationReplay
+{
+public:
+    /**
+     * Creates a Decoration, e.g. through the KPluginFactory of the decoration plugin.
+     * The @p args need to be passed to the Decoration's constructor.
+     **/
+    using Factory = std::function<Decoration *(QObject *parent, const QVariantList &args)>;
+
+    explicit DecorationReplay(const Factory &factory);
+    ~DecorationReplay();
+
+    /**
+     * Replays the trace read from @p device.
+     * @returns @c false if the trace is malformed or the Decoration could not be created
+     **/
+    bool replay(QIODevice *device);
+
+    /**
+     * The number of replayed records, excluding the recorded updates.
+     **/
+    int eventCount() const;
+    /**
+     * The number of updates the Decoration passed to the DecorationBridge during the replay.
+     **/
+    int bridgeUpdates() const;
+    /**
+     * The number of updates the Decoration passed to the DecorationBridge while recording.
+     **/
+    int recordedBridgeUpdates() const;
+    /**
+     * The latency in nanoseconds below which @p percentile percent of the replayed records
+     * got dispatched and rendered.
+     **/
+    qint64 latency(qreal percentile) const;
+
+    /**
+     * The replayed Decoration, @c nullptr before replay.
+     **/
+    Decoration *decoration() const;
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
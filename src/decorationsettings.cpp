@@ -15,6 +15,8 @@ DecorationSettings::DecorationSettings(DecorationBridge *bridge, QObject *parent
     : QObject(parent)
     , d(std::move(bridge->settings(this)))
 {
+    // for queued connections to changed
+    qRegisterMetaType<Fields>();
     auto updateUnits = [this] {
         int gridUnit = QFontMetrics(font()).boundingRect(QLatin1Char('M')).height();
         ;
@@ -32,7 +34,57 @@ DecorationSettings::DecorationSettings(DecorationBridge *bridge, QObject *parent
         }
     };
     updateUnits();
-    connect(this, &DecorationSettings::fontChanged, this, updateUnits);
+
+    // the fields changed in the current batch of the backend
+    auto pending = std::shared_ptr<Fields>(new Fields);
+    auto notify = [this, pending](Field field) {
+        if (d->isUpdating()) {
+            *pending |= field;
+        } else {
+            emit changed(field);
+        }
+    };
+    d->setUpdateFinishedCallback([this, pending] {
+        const Fields fields = *pending;
+        *pending = Fields();
+        if (fields) {
+            emit changed(fields);
+        }
+    });
+    connect(this, &DecorationSettings::onAllDesktopsAvailableChanged, this, [notify] {
+        notify(Field::OnAllDesktopsAvailable);
+    });
+    connect(this, &DecorationSettings::alphaChannelSupportedChanged, this, [notify] {
+        notify(Field::AlphaChannelSupported);
+    });
+    connect(this, &DecorationSettings::closeOnDoubleClickOnMenuChanged, this, [notify] {
+        notify(Field::CloseOnDoubleClickOnMenu);
+    });
+    connect(this, &DecorationSettings::decorationButtonsLeftChanged, this, [notify] {
+        notify(Field::DecorationButtonsLeft);
+    });
+    connect(this, &DecorationSettings::decorationButtonsRightChanged, this, [notify] {
+        notify(Field::DecorationButtonsRight);
+    });
+    connect(this, &DecorationSettings::borderSizeChanged, this, [notify] {
+        notify(Field::BorderSize);
+    });
+    connect(this, &DecorationSettings::gridUnitChanged, this, [notify] {
+        notify(Field::GridUnit);
+    });
+    connect(this, &DecorationSettings::spacingChanged, this, [notify] {
+        notify(Field::Spacing);
+    });
+    connect(this, &DecorationSettings::reconfigured, this, [notify] {
+        notify(Field::Reconfigured);
+    });
+    // the units follow the font, report them together
+    connect(this, &DecorationSettings::fontChanged, this, [this, updateUnits, notify] {
+        d->beginUpdate();
+        updateUnits();
+        notify(Field::Font);
+        d->endUpdate();
+    });
 }
 
 DecorationSettings::~DecorationSettings() = default;
@@ -86,6 +86,28 @@ class KDECORATIONS2_EXPORT DecorationSettings : public QObject
      */
     Q_PROPERTY(int largeSpacing READ largeSpacing NOTIFY spacingChanged)
 public:
+    /**
+     * The settings reported by the changed signal.
+     * @since 5.22
+     **/
+    enum class Field {
+        OnAllDesktopsAvailable = 1 << 0,
+        AlphaChannelSupported = 1 << 1,
+        CloseOnDoubleClickOnMenu = 1 << 2,
+        DecorationButtonsLeft = 1 << 3,
+        DecorationButtonsRight = 1 << 4,
+        BorderSize = 1 << 5,
+        Font = 1 << 6,
+        GridUnit = 1 << 7,
+        Spacing = 1 << 8,
+        /**
+         * The backend got reconfigured, see reconfigured.
+         **/
+        Reconfigured = 1 << 9,
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+    Q_FLAG(Fields)
+
     explicit DecorationSettings(DecorationBridge *bridge, QObject *parent = nullptr);
     ~DecorationSettings() override;
     bool isOnAllDesktopsAvailable() const;
@@ -124,12 +146,25 @@ Q_SIGNALS:
      **/
     void reconfigured();
 
+    /**
+     * This signal is emitted once for all the @p fields changed together, e.g. by a
+     * reconfigure of the backend, after the signals for the individual settings.
+     * A Decoration connecting to it instead of the individual signals only needs to
+     * update its layout once.
+     * @since 5.22
+     **/
+    void changed(KDecoration2::DecorationSettings::Fields fields);
+
 private:
+    friend class DecorationButtonGroup;
     const std::unique_ptr<DecorationSettingsPrivate> d;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(DecorationSettings::Fields)
+
 }
 
 Q_DECLARE_METATYPE(KDecoration2::BorderSize)
+Q_DECLARE_METATYPE(KDecoration2::DecorationSettings::Fields)
 
 #endif
@@ -4,16 +4,50 @@
  * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
  */
 #include "decorationshadow.h"
+#include "decorationcounters_p.h"
 #include "decorationshadow_p.h"
 
+#include <atomic>
+
 namespace KDecoration2
 {
+namespace
+{
+std::atomic<quint64> s_generation{0};
+}
+
 DecorationShadow::Private::Private(DecorationShadow *parent)
     : q(parent)
 {
+    Counters::add(Counters::ShadowsAlive);
+    updateGeneration();
+}
+
+DecorationShadow::Private::~Private()
+{
+    Counters::add(Counters::ShadowsAlive, -1);
+    Counters::add(Counters::ShadowBytes, -shadow.sizeInBytes());
+}
+
+bool DecorationShadow::Private::isSameShadow(const QImage &image, quint64 hash) const
+{
+    // shared or copied from the same image
+    if (shadow.cacheKey() == image.cacheKey()) {
+        return true;
+    }
+    if (shadow.size() != image.size() || shadow.format() != image.format()) {
+        return false;
+    }
+    if (contentHash != 0 && hash != 0) {
+        return contentHash == hash;
+    }
+    return shadow == image;
 }
 
-DecorationShadow::Private::~Private() = default;
+void DecorationShadow::Private::updateGeneration()
+{
+    generation = s_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
 
 DecorationShadow::DecorationShadow()
     : QObject()
@@ -111,6 +145,8 @@ QRect DecorationShadow::leftGeometry() const
     }
 
 DELEGATE(QImage, shadow)
+DELEGATE(quint64, contentHash)
+DELEGATE(quint64, generation)
 DELEGATE(QMargins, padding)
 DELEGATE(QRect, innerShadowRect)
 
@@ -126,21 +162,27 @@ I(left, Left)
 #undef I
 
 #undef DELEGATE
+#endif
 
-#define SETTER(type, setName, name)                                                                                                                            \
-    void DecorationShadow::setName(type arg)                                                                                                                   \
-    {                                                                                                                                                          \
-        if (d->name == arg) {                                                                                                                                  \
-            return;                                                                                                                                            \
-        }                                                                                                                                                      \
-        d->name = arg;                                                                                                                                         \
-        emit name##Changed(d->name);                                                                                                                           \
-    }
-
-SETTER(const QImage &, setShadow, shadow)
+void DecorationShadow::setShadow(const QImage &image)
+{
+    setShadow(image, 0);
+}
 
-#undef SETTER
-#endif
+void DecorationShadow::setShadow(const QImage &image, quint64 contentHash)
+{
+    if (d->isSameShadow(image, contentHash)) {
+        if (contentHash != 0) {
+            d->contentHash = contentHash;
+        }
+        return;
+    }
+    Counters::add(Counters::ShadowBytes, image.sizeInBytes() - d->shadow.sizeInBytes());
+    d->shadow = image;
+    d->contentHash = contentHash;
+    d->updateGeneration();
+    emit shadowChanged(d->shadow);
+}
 
 void DecorationShadow::setPadding(const QMargins &margins)
 {
@@ -148,6 +190,7 @@ void DecorationShadow::setPadding(const QMargins &margins)
         return;
     }
     d->padding = margins;
+    d->updateGeneration();
     emit paddingChanged();
 }
 
@@ -157,6 +200,7 @@ void DecorationShadow::setInnerShadowRect(const QRect &rect)
         return;
     }
     d->innerShadowRect = rect;
+    d->updateGeneration();
     emit innerShadowRectChanged();
 }
 
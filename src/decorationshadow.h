@@ -110,7 +110,28 @@ public:
     int paddingLeft() const;
     QMargins padding() const;
 
+    /**
+     * The hash passed to setShadow together with the shadow image, @c 0 if none got passed.
+     * @since 5.22
+     **/
+    quint64 contentHash() const;
+    /**
+     * A value identifying the current state of the DecorationShadow. It changes whenever the
+     * shadow image, the innerShadowRect or the padding changes and is unique among all
+     * DecorationShadows in the process. Consumers can remember it to skip updating e.g.
+     * textures if it did not change.
+     * @since 5.22
+     **/
+    quint64 generation() const;
+
     void setShadow(const QImage &image);
+    /**
+     * Sets the shadow @p image with a @p contentHash identifying its pixels, e.g. a hash of
+     * the parameters the image got rendered from. Setting an image with the same non-zero
+     * hash as the current one does not compare the pixels of the images.
+     * @since 5.22
+     **/
+    void setShadow(const QImage &image, quint64 contentHash);
     void setInnerShadowRect(const QRect &rect);
     void setPadding(const QMargins &margins);
 
@@ -28,7 +28,11 @@ class Q_DECL_HIDDEN DecorationShadow::Private
 public:
     explicit Private(DecorationShadow *parent);
     ~Private();
+    bool isSameShadow(const QImage &image, quint64 hash) const;
+    void updateGeneration();
     QImage shadow;
+    quint64 contentHash = 0;
+    quint64 generation = 0;
     QRect innerShadowRect;
     QMargins padding;
 
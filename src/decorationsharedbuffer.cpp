@@ -0,0 +1,361 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationsharedbuffer.h"
+#include "decoration.h"
+#include "decoration_p.h"
+
+#include <QDataStream>
+#include <QPainter>
+#include <QPointer>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace KDecoration2
+{
+namespace
+{
+void closeFd(int fd)
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool signalFence(int fd)
+{
+    const quint64 value = 1;
+    ssize_t written;
+    do {
+        written = write(fd, &value, sizeof(value));
+    } while (written < 0 && errno == EINTR);
+    return written == sizeof(value);
+}
+
+/**
+ * Waits for one of the @p fds to be signalled and resets it.
+ * @returns the index of the signalled fence or @c -1 on timeout
+ **/
+int waitFences(const QVector<int> &fds, int timeout)
+{
+    QVector<pollfd> pfds;
+    pfds.reserve(fds.count());
+    for (int fd : fds) {
+        pfds.append({fd, POLLIN, 0});
+    }
+    int ready;
+    do {
+        ready = poll(pfds.data(), pfds.count(), timeout);
+    } while (ready < 0 && errno == EINTR);
+    if (ready <= 0) {
+        return -1;
+    }
+    for (int i = 0; i < pfds.count(); ++i) {
+        if (pfds.at(i).revents & POLLIN) {
+            quint64 value;
+            if (read(fds.at(i), &value, sizeof(value)) == sizeof(value)) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+}
+
+class Q_DECL_HIDDEN DecorationSharedBuffer::Private
+{
+public:
+    ~Private();
+    bool map(bool writable);
+    bool isValidIndex(int index) const
+    {
+        return index >= 0 && index < handle.readyFences.count();
+    }
+
+    Handle handle;
+    int stride = 0;
+    qsizetype bufferBytes = 0;
+    uchar *memory = nullptr;
+    qsizetype mappedBytes = 0;
+    // only the renderer maps the memory writable
+    bool writable = false;
+    // renderer side
+    QVector<bool> released;
+    QVector<QRegion> stale;
+    // the Decoration last rendered, which this takes the damage of
+    QPointer<Decoration> decoration;
+};
+
+DecorationSharedBuffer::Private::~Private()
+{
+    if (memory) {
+        munmap(memory, mappedBytes);
+    }
+    closeFd(handle.memoryFd);
+    for (int fd : qAsConst(handle.readyFences)) {
+        closeFd(fd);
+    }
+    for (int fd : qAsConst(handle.releaseFences)) {
+        closeFd(fd);
+    }
+}
+
+bool DecorationSharedBuffer::Private::map(bool writable)
+{
+    if (handle.size.width() > MaximumSize || handle.size.height() > MaximumSize) {
+        return false;
+    }
+    stride = handle.size.width() * 4;
+    bufferBytes = qsizetype(stride) * handle.size.height();
+    mappedBytes = bufferBytes * handle.readyFences.count();
+    struct stat info;
+    if (mappedBytes <= 0 || fstat(handle.memoryFd, &info) != 0 || info.st_size < mappedBytes) {
+        return false;
+    }
+    void *data = mmap(nullptr, mappedBytes, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, handle.memoryFd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    memory = static_cast<uchar *>(data);
+    this->writable = writable;
+    return true;
+}
+
+bool DecorationSharedBuffer::Frame::isValid() const
+{
+    return index >= 0;
+}
+
+QByteArray DecorationSharedBuffer::Frame::toByteArray() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << qint32(index) << damage;
+    return data;
+}
+
+DecorationSharedBuffer::Frame DecorationSharedBuffer::Frame::fromByteArray(const QByteArray &data)
+{
+    QDataStream stream(data);
+    qint32 index = -1;
+    Frame frame;
+    stream >> index >> frame.damage;
+    // sent by the other process, the index gets checked against the buffer again when used
+    if (stream.status() == QDataStream::Ok && index >= 0 && index < MaximumCount) {
+        frame.index = index;
+    } else {
+        frame.damage = QRegion();
+    }
+    return frame;
+}
+
+DecorationSharedBuffer::DecorationSharedBuffer()
+    : d(new Private)
+{
+}
+
+DecorationSharedBuffer::~DecorationSharedBuffer()
+{
+    if (d->decoration) {
+        d->decoration->d->releaseDamage(this);
+    }
+}
+
+std::unique_ptr<DecorationSharedBuffer> DecorationSharedBuffer::create(const QSize &size, qreal scale, int count)
+{
+    if (size.isEmpty() || size.width() > MaximumSize || size.height() > MaximumSize || count < 1 || count > MaximumCount) {
+        return nullptr;
+    }
+    std::unique_ptr<DecorationSharedBuffer> buffer(new DecorationSharedBuffer);
+    Handle &handle = buffer->d->handle;
+    handle.size = size;
+    handle.scale = scale;
+    handle.memoryFd = memfd_create("kdecoration", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (handle.memoryFd < 0) {
+        return nullptr;
+    }
+    for (int i = 0; i < count; ++i) {
+        handle.readyFences << eventfd(0, EFD_CLOEXEC);
+        handle.releaseFences << eventfd(0, EFD_CLOEXEC);
+        if (handle.readyFences.last() < 0 || handle.releaseFences.last() < 0) {
+            return nullptr;
+        }
+    }
+    const off_t bytes = off_t(size.width()) * 4 * size.height() * count;
+    if (ftruncate(handle.memoryFd, bytes) != 0) {
+        return nullptr;
+    }
+    // lets the compositor verify that the renderer cannot shrink the memory it has mapped,
+    // accessing the truncated pages would crash the compositor with SIGBUS
+    if (fcntl(handle.memoryFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        return nullptr;
+    }
+    if (!buffer->d->map(true)) {
+        return nullptr;
+    }
+    buffer->d->released.fill(true, count);
+    buffer->d->stale.fill(QRegion(QRect(QPoint(0, 0), size)), count);
+    return buffer;
+}
+
+std::unique_ptr<DecorationSharedBuffer> DecorationSharedBuffer::fromHandle(const Handle &handle)
+{
+    if (handle.size.isEmpty() || handle.readyFences.isEmpty() || handle.readyFences.count() > MaximumCount
+        || handle.readyFences.count() != handle.releaseFences.count()) {
+        return nullptr;
+    }
+    std::unique_ptr<DecorationSharedBuffer> buffer(new DecorationSharedBuffer);
+    Handle &ownHandle = buffer->d->handle;
+    ownHandle.size = handle.size;
+    ownHandle.scale = handle.scale;
+    ownHandle.memoryFd = fcntl(handle.memoryFd, F_DUPFD_CLOEXEC, 0);
+    for (int i = 0; i < handle.readyFences.count(); ++i) {
+        ownHandle.readyFences << fcntl(handle.readyFences.at(i), F_DUPFD_CLOEXEC, 0);
+        ownHandle.releaseFences << fcntl(handle.releaseFences.at(i), F_DUPFD_CLOEXEC, 0);
+        if (ownHandle.readyFences.last() < 0 || ownHandle.releaseFences.last() < 0) {
+            return nullptr;
+        }
+    }
+    if (ownHandle.memoryFd < 0) {
+        return nullptr;
+    }
+    // the renderer is not trusted, without the seal it could truncate the memory while it is
+    // mapped; map checks the size
+    const int seals = fcntl(ownHandle.memoryFd, F_GET_SEALS);
+    if (seals < 0 || !(seals & F_SEAL_SHRINK) || !buffer->d->map(false)) {
+        return nullptr;
+    }
+    return buffer;
+}
+
+DecorationSharedBuffer::Handle DecorationSharedBuffer::handle() const
+{
+    return d->handle;
+}
+
+int DecorationSharedBuffer::count() const
+{
+    return d->handle.readyFences.count();
+}
+
+QSize DecorationSharedBuffer::size() const
+{
+    return d->handle.size;
+}
+
+qreal DecorationSharedBuffer::scale() const
+{
+    return d->handle.scale;
+}
+
+QImage DecorationSharedBuffer::image(int index) const
+{
+    if (!d->isValidIndex(index)) {
+        return QImage();
+    }
+    const QSize size = d->handle.size;
+    uchar *data = d->memory + index * d->bufferBytes;
+    // a read-only QImage copies the pixels before writing to them
+    QImage image = d->writable ? QImage(data, size.width(), size.height(), d->stride, QImage::Format_ARGB32_Premultiplied)
+                               : QImage(static_cast<const uchar *>(data), size.width(), size.height(), d->stride, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(d->handle.scale);
+    return image;
+}
+
+int DecorationSharedBuffer::acquire(int timeout)
+{
+    // collect all buffers released so far without blocking
+    int released;
+    while ((released = waitFences(d->handle.releaseFences, 0)) >= 0) {
+        d->released[released] = true;
+    }
+    for (int i = 0; i < d->released.count(); ++i) {
+        if (d->released.at(i)) {
+            d->released[i] = false;
+            return i;
+        }
+    }
+    released = waitFences(d->handle.releaseFences, timeout);
+    return released;
+}
+
+QRegion DecorationSharedBuffer::staleRegion(int index) const
+{
+    return d->stale.value(index);
+}
+
+void DecorationSharedBuffer::present(int index, const QRegion &damage)
+{
+    if (!d->isValidIndex(index)) {
+        return;
+    }
+    for (int i = 0; i < d->stale.count(); ++i) {
+        if (i == index) {
+            d->stale[i] = QRegion();
+        } else {
+            d->stale[i] += damage;
+        }
+    }
+    signalFence(d->handle.readyFences.at(index));
+}
+
+DecorationSharedBuffer::Frame DecorationSharedBuffer::render(Decoration *decoration, int timeout)
+{
+    Frame frame;
+    const int index = acquire(timeout);
+    if (index < 0) {
+        return frame;
+    }
+    const qreal scale = d->handle.scale;
+    const QRect bounds(QPoint(0, 0), d->handle.size);
+    // the buffer needs to catch up with the frames presented in the other buffers
+    if (d->decoration != decoration) {
+        if (d->decoration) {
+            d->decoration->d->releaseDamage(this);
+        }
+        d->decoration = decoration;
+    }
+    const QRegion region = (decoration->d->takeDamage(scale, this) + d->stale.at(index)) & bounds;
+    if (!region.isEmpty()) {
+        const QRectF deviceRect = region.boundingRect();
+        const QRect repaintArea = QRectF(deviceRect.topLeft() / scale, deviceRect.size() / scale).toAlignedRect();
+        QImage target = image(index);
+        QPainter painter(&target);
+        painter.setClipRect(repaintArea);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(repaintArea, Qt::transparent);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        decoration->d->paint(&painter, repaintArea, scale, nullptr);
+    }
+    present(index, region);
+    frame.index = index;
+    frame.damage = region;
+    return frame;
+}
+
+bool DecorationSharedBuffer::waitReady(int index, int timeout)
+{
+    if (!d->isValidIndex(index)) {
+        return false;
+    }
+    return waitFences({d->handle.readyFences.at(index)}, timeout) == 0;
+}
+
+bool DecorationSharedBuffer::release(int index)
+{
+    if (!d->isValidIndex(index)) {
+        return false;
+    }
+    return signalFence(d->handle.releaseFences.at(index));
+}
+
+}
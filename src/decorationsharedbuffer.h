@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_SHARED_BUFFER_H
+#define KDECORATION2_DECORATION_SHARED_BUFFER_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QByteArray>
+#include <QImage>
+#include <QRegion>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <memory>
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Back-buffers of a Decoration in memory shared between two processes.
+ *
+ * Used if the Decoration is rendered in a different process than the compositor, e.g. a
+ * sandboxed helper process for crash isolation. The renderer creates the DecorationSharedBuffer,
+ * which allocates two or three buffers in a single memfd, and passes its Handle to the
+ * compositor, e.g. as SCM_RIGHTS over a local socket. The compositor maps the Handle with
+ * fromHandle and reads the pixels directly from the shared memory, only the Frames need to
+ * be sent for each update.
+ *
+ * Access to the buffers is synchronized with one pair of eventfd fences per buffer:
+ * @li the renderer paints into a buffer returned by acquire, presents it and sends the
+ *     Frame to the compositor
+ * @li the compositor waits for the buffer to be ready, reads it and releases it
+ * @li acquire only returns buffers which got released by the compositor
+ *
+ * Only available on Linux.
+ *
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationSharedBuffer
+{
+public:
+    /**
+     * The most buffers in one DecorationSharedBuffer.
+     **/
+    static const int MaximumCount = 8;
+    /**
+     * The largest width and height of a buffer in physical pixels.
+     **/
+    static const int MaximumSize = 16384;
+
+    /**
+     * What the other process needs to map the buffers.
+     **/
+    struct Handle {
+        int memoryFd = -1;
+        /**
+         * Signalled by the renderer once the buffer is presented.
+         **/
+        QVector<int> readyFences;
+        /**
+         * Signalled by the compositor once it no longer reads the buffer.
+         **/
+        QVector<int> releaseFences;
+        /**
+         * In physical pixels.
+         **/
+        QSize size;
+        qreal scale = 1.0;
+    };
+
+    /**
+     * A presented buffer, sent from the renderer to the compositor.
+     **/
+    struct KDECORATIONS2_EXPORT Frame {
+        int index = -1;
+        /**
+         * The area of the buffer which changed, in physical pixels.
+         **/
+        QRegion damage;
+
+        bool isValid() const;
+        QByteArray toByteArray() const;
+        /**
+         * The Frame is invalid if @p data is corrupt or the index out of range.
+         **/
+        static Frame fromByteArray(const QByteArray &data);
+    };
+
+    /**
+     * Allocates @p count buffers of @p size physical pixels in a sealed memfd.
+     * @returns @c nullptr if the buffers could not be allocated
+     **/
+    static std::unique_ptr<DecorationSharedBuffer> create(const QSize &size, qreal scale = 1.0, int count = 2);
+    /**
+     * Maps the buffers described by @p handle read-only. The file descriptors are duplicated,
+     * the caller keeps ownership of the ones in @p handle.
+     * @returns @c nullptr if the buffers could not be mapped, or if the memfd is smaller than
+     * the buffers or not sealed against shrinking
+     **/
+    static std::unique_ptr<DecorationSharedBuffer> fromHandle(const Handle &handle);
+    ~DecorationSharedBuffer();
+
+    /**
+     * The file descriptors stay owned by this DecorationSharedBuffer.
+     **/
+    Handle handle() const;
+    int count() const;
+    QSize size() const;
+    qreal scale() const;
+    /**
+     * The buffer at @p index. The QImage does not own the shared memory and must not be
+     * used after the DecorationSharedBuffer got destroyed. It is read-only for a
+     * DecorationSharedBuffer created by fromHandle, and null if @p index is out of range.
+     **/
+    QImage image(int index) const;
+
+    /**
+     * Renderer: Blocks up to @p timeout milliseconds until a buffer is released by the
+     * compositor, a @p timeout of @c -1 waits forever.
+     * @returns The index of the buffer or @c -1 on timeout
+     **/
+    int acquire(int timeout = -1);
+    /**
+     * Renderer: The area of the buffer at @p index which changed since it was presented
+     * the last time.
+     **/
+    QRegion staleRegion(int index) const;
+    /**
+     * Renderer: Marks the buffer at @p index as ready for the compositor.
+     **/
+    void present(int index, const QRegion &damage);
+    /**
+     * Renderer: Repaints the damage of @p decoration at the scale into an acquired buffer
+     * and presents it. The returned Frame is invalid if no buffer was released within
+     * @p timeout milliseconds.
+     *
+     * This takes the damage of the scale from @p decoration, until the DecorationSharedBuffer
+     * is destroyed or renders another Decoration no DecorationTileBuffer or
+     * DecorationRenderScheduler may render @p decoration at the same scale.
+     **/
+    Frame render(Decoration *decoration, int timeout = -1);
+
+    /**
+     * Compositor: Blocks up to @p timeout milliseconds until the buffer at @p index got
+     * presented.
+     * @returns @c false on timeout or if @p index is out of range
+     **/
+    bool waitReady(int index, int timeout = -1);
+    /**
+     * Compositor: Hands the buffer at @p index back to the renderer.
+     * @returns @c false if @p index is out of range
+     **/
+    bool release(int index);
+
+private:
+    DecorationSharedBuffer();
+    Q_DISABLE_COPY(DecorationSharedBuffer)
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationsnapshot.h"
+#include "decoratedclient.h"
+#include "decoration.h"
+#include "decoration_p.h"
+#include "decorationbutton.h"
+#include "decorationsettings.h"
+
+#include <QVector>
+
+namespace KDecoration2
+{
+class Q_DECL_HIDDEN DecorationSnapshot::Private : public QSharedData
+{
+public:
+    static constexpr int s_colorGroups = int(ColorGroup::Warning) + 1;
+    static constexpr int s_colorRoles = int(ColorRole::Foreground) + 1;
+
+    struct Button {
+        DecorationButtonType type;
+        QRectF geometry;
+        quint8 state;
+    };
+    bool testButtonState(int index, quint8 flags) const
+    {
+        return (buttons.at(index).state & flags) == flags;
+    }
+
+    QRect rect;
+    QMargins borders;
+    QRect titleBar;
+    bool opaque = false;
+
+    bool active = false;
+    bool maximized = false;
+    bool shaded = false;
+    bool keepAbove = false;
+    bool keepBelow = false;
+    bool onAllDesktops = false;
+    QString caption;
+    QPalette palette;
+    QColor colors[s_colorGroups * s_colorRoles];
+
+    QFont font;
+    int smallSpacing = 0;
+    int largeSpacing = 0;
+    BorderSize borderSize = BorderSize::Normal;
+
+    QVector<Button> buttons;
+};
+
+DecorationSnapshot::DecorationSnapshot() = default;
+
+DecorationSnapshot::DecorationSnapshot(const Decoration *decoration)
+    : d(new Private)
+{
+    d->rect = decoration->rect();
+    d->borders = decoration->borders();
+    d->titleBar = decoration->titleBar();
+    d->opaque = decoration->isOpaque();
+
+    if (const auto client = decoration->client().toStrongRef()) {
+        d->active = client->isActive();
+        d->maximized = client->isMaximized();
+        d->shaded = client->isShaded();
+        d->keepAbove = client->isKeepAbove();
+        d->keepBelow = client->isKeepBelow();
+        d->onAllDesktops = client->isOnAllDesktops();
+        d->caption = client->caption();
+        d->palette = client->palette();
+        for (int group = 0; group < Private::s_colorGroups; ++group) {
+            for (int role = 0; role < Private::s_colorRoles; ++role) {
+                d->colors[group * Private::s_colorRoles + role] = client->color(ColorGroup(group), ColorRole(role));
+            }
+        }
+    }
+
+    if (const auto settings = decoration->settings()) {
+        d->font = settings->font();
+        d->smallSpacing = settings->smallSpacing();
+        d->largeSpacing = settings->largeSpacing();
+        d->borderSize = settings->borderSize();
+    }
+
+    const DecorationButtonModel &buttons = decoration->d->buttons;
+    d->buttons.reserve(buttons.count());
+    for (int i = 0; i < buttons.count(); ++i) {
+        d->buttons.append({buttons.type(i), buttons.button(i)->geometry(), buttons.state(i)});
+    }
+}
+
+DecorationSnapshot::DecorationSnapshot(const DecorationSnapshot &other) = default;
+
+DecorationSnapshot::~DecorationSnapshot() = default;
+
+DecorationSnapshot &DecorationSnapshot::operator=(const DecorationSnapshot &other) = default;
+
+bool DecorationSnapshot::isValid() const
+{
+    return d;
+}
+
+#define DELEGATE(name, variableName, type, defaultValue)                                                                                                       \
+    type DecorationSnapshot::name() const                                                                                                                      \
+    {                                                                                                                                                          \
+        return d ? d->variableName : defaultValue;                                                                                                             \
+    }
+
+DELEGATE(rect, rect, QRect, QRect())
+DELEGATE(borders, borders, QMargins, QMargins())
+DELEGATE(titleBar, titleBar, QRect, QRect())
+DELEGATE(isOpaque, opaque, bool, false)
+DELEGATE(isActive, active, bool, false)
+DELEGATE(caption, caption, QString, QString())
+DELEGATE(isMaximized, maximized, bool, false)
+DELEGATE(isShaded, shaded, bool, false)
+DELEGATE(isKeepAbove, keepAbove, bool, false)
+DELEGATE(isKeepBelow, keepBelow, bool, false)
+DELEGATE(isOnAllDesktops, onAllDesktops, bool, false)
+DELEGATE(palette, palette, QPalette, QPalette())
+DELEGATE(font, font, QFont, QFont())
+DELEGATE(smallSpacing, smallSpacing, int, 0)
+DELEGATE(largeSpacing, largeSpacing, int, 0)
+DELEGATE(borderSize, borderSize, BorderSize, BorderSize::Normal)
+DELEGATE(buttonCount, buttons.count(), int, 0)
+
+#undef DELEGATE
+
+QColor DecorationSnapshot::color(ColorGroup group, ColorRole role) const
+{
+    if (!d) {
+        return QColor();
+    }
+    return d->colors[int(group) * Private::s_colorRoles + int(role)];
+}
+
+DecorationButtonType DecorationSnapshot::buttonType(int index) const
+{
+    return d->buttons.at(index).type;
+}
+
+QRectF DecorationSnapshot::buttonGeometry(int index) const
+{
+    return d->buttons.at(index).geometry;
+}
+
+#define BUTTON_STATE(name, flag)                                                                                                                               \
+    bool DecorationSnapshot::name(int index) const                                                                                                             \
+    {                                                                                                                                                          \
+        return d->testButtonState(index, DecorationButtonModel::flag);                                                                                         \
+    }
+
+BUTTON_STATE(isButtonVisible, Visible)
+BUTTON_STATE(isButtonEnabled, Enabled)
+BUTTON_STATE(isButtonHovered, Hovered)
+BUTTON_STATE(isButtonPressed, Pressed)
+BUTTON_STATE(isButtonChecked, Checked)
+
+#undef BUTTON_STATE
+
+}
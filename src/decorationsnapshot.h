@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_SNAPSHOT_H
+#define KDECORATION2_DECORATION_SNAPSHOT_H
+
+#include "decorationdefines.h"
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QFont>
+#include <QMargins>
+#include <QPalette>
+#include <QRect>
+#include <QSharedDataPointer>
+#include <QString>
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Immutable copy of the state a Decoration is rendered with.
+ *
+ * The DecorationSnapshot copies the state of the Decoration, its DecoratedClient, its
+ * DecorationSettings and its DecorationButtons at the time it is created. It can be passed
+ * to and read from any thread, while the objects it was created from may only be used
+ * from the GUI thread.
+ *
+ * A Decoration which supports threaded rendering uses the Decoration::renderSnapshot in
+ * its paint method instead of accessing the DecoratedClient, the DecorationSettings or
+ * the DecorationButtons.
+ *
+ * @see Decoration::supportsThreadedRendering
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationSnapshot
+{
+public:
+    /**
+     * Creates an invalid DecorationSnapshot.
+     **/
+    DecorationSnapshot();
+    /**
+     * Copies the current state of @p decoration. Must be invoked from the GUI thread.
+     **/
+    explicit DecorationSnapshot(const Decoration *decoration);
+    DecorationSnapshot(const DecorationSnapshot &other);
+    ~DecorationSnapshot();
+    DecorationSnapshot &operator=(const DecorationSnapshot &other);
+
+    bool isValid() const;
+
+    /**
+     * @see Decoration::rect
+     **/
+    QRect rect() const;
+    QMargins borders() const;
+    QRect titleBar() const;
+    bool isOpaque() const;
+
+    /**
+     * @see DecoratedClient
+     **/
+    bool isActive() const;
+    QString caption() const;
+    bool isMaximized() const;
+    bool isShaded() const;
+    bool isKeepAbove() const;
+    bool isKeepBelow() const;
+    bool isOnAllDesktops() const;
+    QPalette palette() const;
+    QColor color(ColorGroup group, ColorRole role) const;
+
+    /**
+     * @see DecorationSettings
+     **/
+    QFont font() const;
+    int smallSpacing() const;
+    int largeSpacing() const;
+    BorderSize borderSize() const;
+
+    /**
+     * The DecorationButtons in the order they were added to the Decoration.
+     **/
+    int buttonCount() const;
+    DecorationButtonType buttonType(int index) const;
+    QRectF buttonGeometry(int index) const;
+    bool isButtonVisible(int index) const;
+    bool isButtonEnabled(int index) const;
+    bool isButtonHovered(int index) const;
+    bool isButtonPressed(int index) const;
+    bool isButtonChecked(int index) const;
+
+private:
+    class Private;
+    QSharedDataPointer<Private> d;
+};
+
+} // namespace
+
+#endif
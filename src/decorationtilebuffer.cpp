@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationtilebuffer.h"
+#include "decoration.h"
+#include "decoration_p.h"
+
+#include <QPainter>
+#include <QPointer>
+
+namespace KDecoration2
+{
+class Q_DECL_HIDDEN DecorationTileBuffer::Private
+{
+public:
+    Private(Decoration *decoration, qreal scale, const QSize &tileSize);
+
+    /**
+     * Recreates all tiles if the size of the Decoration changed.
+     **/
+    void resize();
+    QRect tileRect(int index) const;
+    void markDirty(const QRect &rect);
+    void repaint(int index);
+
+    QPointer<Decoration> decoration;
+    qreal scale;
+    QSize tileSize;
+    QSize size;
+    int columns = 0;
+    int rows = 0;
+    // row major
+    QVector<QImage> tiles;
+    QVector<bool> dirty;
+    qint64 repaintedBytes = 0;
+};
+
+DecorationTileBuffer::Private::Private(Decoration *decoration, qreal scale, const QSize &tileSize)
+    : decoration(decoration)
+    , scale(scale)
+    , tileSize(tileSize.expandedTo(QSize(1, 1)))
+{
+}
+
+void DecorationTileBuffer::Private::resize()
+{
+    const QSize deviceSize = Decoration::Private::toDevicePixels(decoration->rect(), scale).size();
+    if (deviceSize == size) {
+        return;
+    }
+    size = deviceSize;
+    columns = (size.width() + tileSize.width() - 1) / tileSize.width();
+    rows = (size.height() + tileSize.height() - 1) / tileSize.height();
+    tiles.fill(QImage(), columns * rows);
+    dirty.fill(true, columns * rows);
+}
+
+QRect DecorationTileBuffer::Private::tileRect(int index) const
+{
+    const QPoint position(index % columns * tileSize.width(), index / columns * tileSize.height());
+    return QRect(position, tileSize) & QRect(QPoint(0, 0), size);
+}
+
+void DecorationTileBuffer::Private::markDirty(const QRect &rect)
+{
+    const QRect clipped = rect & QRect(QPoint(0, 0), size);
+    if (clipped.isEmpty()) {
+        return;
+    }
+    const int firstColumn = clipped.left() / tileSize.width();
+    const int lastColumn = clipped.right() / tileSize.width();
+    const int firstRow = clipped.top() / tileSize.height();
+    const int lastRow = clipped.bottom() / tileSize.height();
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            dirty[row * columns + column] = true;
+        }
+    }
+}
+
+void DecorationTileBuffer::Private::repaint(int index)
+{
+    const QRect rect = tileRect(index);
+    QImage &tile = tiles[index];
+    if (tile.size() != rect.size()) {
+        tile = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        tile.setDevicePixelRatio(scale);
+    }
+    tile.fill(Qt::transparent);
+
+    const QRectF logicalRect(QPointF(rect.topLeft()) / scale, QSizeF(rect.size()) / scale);
+    QPainter painter(&tile);
+    painter.translate(-logicalRect.topLeft());
+    decoration->d->paint(&painter, logicalRect.toAlignedRect(), scale, nullptr);
+    repaintedBytes += tile.sizeInBytes();
+    dirty[index] = false;
+}
+
+DecorationTileBuffer::DecorationTileBuffer(Decoration *decoration, qreal scale, const QSize &tileSize)
+    : d(new Private(decoration, scale, tileSize))
+{
+    Q_ASSERT(decoration);
+}
+
+DecorationTileBuffer::~DecorationTileBuffer()
+{
+    if (d->decoration) {
+        d->decoration->d->releaseDamage(this);
+    }
+}
+
+Decoration *DecorationTileBuffer::decoration() const
+{
+    return d->decoration;
+}
+
+qreal DecorationTileBuffer::scale() const
+{
+    return d->scale;
+}
+
+QSize DecorationTileBuffer::tileSize() const
+{
+    return d->tileSize;
+}
+
+QSize DecorationTileBuffer::size() const
+{
+    return d->size;
+}
+
+int DecorationTileBuffer::tileCount() const
+{
+    return d->tiles.count();
+}
+
+QRect DecorationTileBuffer::tileRect(int index) const
+{
+    return d->tileRect(index);
+}
+
+QImage DecorationTileBuffer::tile(int index) const
+{
+    return d->tiles.at(index);
+}
+
+bool DecorationTileBuffer::isDirty(int index) const
+{
+    return d->dirty.at(index);
+}
+
+QVector<int> DecorationTileBuffer::render()
+{
+    d->repaintedBytes = 0;
+    if (!d->decoration) {
+        return QVector<int>();
+    }
+    d->resize();
+    const QRegion damage = d->decoration->d->takeDamage(d->scale, this);
+    for (const QRect &rect : damage) {
+        d->markDirty(rect);
+    }
+
+    QVector<int> repainted;
+    for (int i = 0; i < d->dirty.count(); ++i) {
+        if (d->dirty.at(i)) {
+            d->repaint(i);
+            repainted << i;
+        }
+    }
+    return repainted;
+}
+
+qint64 DecorationTileBuffer::repaintedBytes() const
+{
+    return d->repaintedBytes;
+}
+
+}
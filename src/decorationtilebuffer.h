@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_TILE_BUFFER_H
+#define KDECORATION2_DECORATION_TILE_BUFFER_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QImage>
+#include <QRect>
+#include <QScopedPointer>
+#include <QVector>
+
+namespace KDecoration2
+{
+class Decoration;
+
+/**
+ * @brief Back-buffer of a Decoration split into tiles of a fixed size.
+ *
+ * The title bar of a maximized window on a large output is very wide, but e.g. hovering a
+ * DecorationButton only damages a small part of it. The DecorationTileBuffer splits the
+ * Decoration's back-buffer for one of its scales into tiles and keeps a dirty bit for each of
+ * them. The damage passed to Decoration::update marks the tiles it touches as dirty and only
+ * dirty tiles get repainted by render.
+ *
+ * render returns the tiles which got repainted, so that the DecorationBridge only needs to
+ * upload those to e.g. a texture.
+ *
+ * The DecorationTileBuffer must only be used from the GUI thread. It takes the damage of
+ * its scale from the Decoration, so no other DecorationTileBuffer, DecorationSharedBuffer
+ * or DecorationRenderScheduler may render the Decoration at the same scale while it exists.
+ *
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationTileBuffer
+{
+public:
+    /**
+     * The @p tileSize is in physical pixels of @p scale. The @p scale needs to be one of
+     * the Decoration's scales.
+     **/
+    explicit DecorationTileBuffer(Decoration *decoration, qreal scale = 1.0, const QSize &tileSize = QSize(256, 256));
+    ~DecorationTileBuffer();
+
+    Decoration *decoration() const;
+    qreal scale() const;
+    QSize tileSize() const;
+    /**
+     * The size of the back-buffer in physical pixels.
+     **/
+    QSize size() const;
+
+    int tileCount() const;
+    /**
+     * The geometry of the tile at @p index in physical pixels. Tiles at the right and bottom
+     * edge are smaller than the tileSize if the size is not a multiple of it.
+     **/
+    QRect tileRect(int index) const;
+    /**
+     * The content of the tile at @p index as of the last render. The image's device pixel
+     * ratio is the scale.
+     **/
+    QImage tile(int index) const;
+    bool isDirty(int index) const;
+
+    /**
+     * Marks all tiles touched by the damage of the Decoration as dirty and repaints them.
+     * If the size of the Decoration changed all tiles are repainted.
+     *
+     * @returns The indices of the repainted tiles, which need to be uploaded.
+     **/
+    QVector<int> render();
+    /**
+     * The number of bytes written by the last render.
+     **/
+    qint64 repaintedBytes() const;
+
+private:
+    Q_DISABLE_COPY(DecorationTileBuffer)
+    class Private;
+    const QScopedPointer<Private> d;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationtimerservice_p.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace KDecoration2
+{
+DecorationTimerService::DecorationTimerService()
+{
+    m_timer.setSingleShot(true);
+    QObject::connect(&m_timer, &QTimer::timeout, &m_timer, [this] {
+        expire();
+    });
+}
+
+qint64 DecorationTimerService::now()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void DecorationTimerService::schedule(const void *owner, int msec, const std::function<void()> &callback)
+{
+    cancel(owner);
+    const Deadline deadline{owner, now() + msec, callback};
+    auto it = std::upper_bound(m_deadlines.begin(), m_deadlines.end(), deadline, [](const Deadline &a, const Deadline &b) {
+        return a.time < b.time;
+    });
+    const bool earliest = it == m_deadlines.begin();
+    m_deadlines.insert(it, deadline);
+    if (earliest) {
+        rearm();
+    }
+}
+
+void DecorationTimerService::cancel(const void *owner)
+{
+    m_expired.erase(std::remove_if(m_expired.begin(),
+                                   m_expired.end(),
+                                   [owner](const Deadline &deadline) {
+                                       return deadline.owner == owner;
+                                   }),
+                    m_expired.end());
+    auto it = std::find_if(m_deadlines.begin(), m_deadlines.end(), [owner](const Deadline &deadline) {
+        return deadline.owner == owner;
+    });
+    if (it == m_deadlines.end()) {
+        return;
+    }
+    const bool earliest = it == m_deadlines.begin();
+    m_deadlines.erase(it);
+    if (earliest) {
+        rearm();
+    }
+}
+
+bool DecorationTimerService::isScheduled(const void *owner) const
+{
+    return std::any_of(m_deadlines.begin(), m_deadlines.end(), [owner](const Deadline &deadline) {
+        return deadline.owner == owner;
+    });
+}
+
+int DecorationTimerService::count() const
+{
+    return m_deadlines.count();
+}
+
+void DecorationTimerService::rearm()
+{
+    if (m_deadlines.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(int(std::max<qint64>(0, m_deadlines.first().time - now())));
+}
+
+void DecorationTimerService::expire()
+{
+    const qint64 time = now();
+    auto it = std::find_if(m_deadlines.begin(), m_deadlines.end(), [time](const Deadline &deadline) {
+        return deadline.time > time;
+    });
+    // remove before invoking, the callbacks may schedule new deadlines or cancel the
+    // deadlines of owners they delete
+    m_expired = QVector<Deadline>(m_deadlines.begin(), it);
+    m_deadlines.erase(m_deadlines.begin(), it);
+    rearm();
+    while (!m_expired.isEmpty()) {
+        const Deadline deadline = m_expired.takeFirst();
+        deadline.callback();
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATIONTIMERSERVICE_P_H
+#define KDECORATION2_DECORATIONTIMERSERVICE_P_H
+
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+/**
+ * @brief Deadlines of all DecorationButtons of one Decoration, backed by a single QTimer.
+ *
+ * Each owner can have at most one pending deadline, scheduling a new one
+ * replaces the previous deadline. The timer is always armed for the
+ * earliest deadline.
+ **/
+class Q_DECL_HIDDEN DecorationTimerService
+{
+public:
+    DecorationTimerService();
+
+    /**
+     * @returns a monotonic time in milliseconds.
+     **/
+    static qint64 now();
+
+    /**
+     * Invokes @p callback once @p msec have passed, unless cancelled before. Cancelling also
+     * works from the callback of another owner expiring at the same time, e.g. when that
+     * callback deletes the owner.
+     **/
+    void schedule(const void *owner, int msec, const std::function<void()> &callback);
+    void cancel(const void *owner);
+    bool isScheduled(const void *owner) const;
+    int count() const;
+
+private:
+    struct Deadline {
+        const void *owner;
+        qint64 time;
+        std::function<void()> callback;
+    };
+    void rearm();
+    void expire();
+    // sorted by time, there are only a few entries at most
+    QVector<Deadline> m_deadlines;
+    // removed from m_deadlines but not invoked yet, cancel removes them as well
+    QVector<Deadline> m_expired;
+    QTimer m_timer;
+};
+
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationtooltipscheduler_p.h"
+#include "decorationtimerservice_p.h"
+
+namespace KDecoration2
+{
+DecorationToolTipScheduler::DecorationToolTipScheduler(const Clock &clock)
+    : m_clock(clock ? clock : Clock(DecorationTimerService::now))
+{
+}
+
+void DecorationToolTipScheduler::setShowCallback(const std::function<void(const QString &)> &callback)
+{
+    m_showCallback = callback;
+}
+
+void DecorationToolTipScheduler::setHideCallback(const std::function<void()> &callback)
+{
+    m_hideCallback = callback;
+}
+
+void DecorationToolTipScheduler::setWakeUpCallback(const std::function<void(int)> &callback)
+{
+    m_wakeUpCallback = callback;
+}
+
+#define SETTER(name, variableName)                                                                                                                             \
+    void DecorationToolTipScheduler::name(int msec)                                                                                                           \
+    {                                                                                                                                                          \
+        variableName = msec;                                                                                                                                   \
+    }
+
+SETTER(setShowDelay, m_showDelay)
+SETTER(setHideGracePeriod, m_hideGracePeriod)
+SETTER(setWarmPeriod, m_warmPeriod)
+
+#undef SETTER
+
+#define GETTER(name, variableName, type)                                                                                                                       \
+    type DecorationToolTipScheduler::name() const                                                                                                              \
+    {                                                                                                                                                          \
+        return variableName;                                                                                                                                   \
+    }
+
+GETTER(showDelay, m_showDelay, int)
+GETTER(hideGracePeriod, m_hideGracePeriod, int)
+GETTER(warmPeriod, m_warmPeriod, int)
+GETTER(text, m_shownText, QString)
+GETTER(deadline, m_deadline, qint64)
+
+#undef GETTER
+
+bool DecorationToolTipScheduler::isVisible() const
+{
+    return m_state == State::Visible || m_state == State::PendingHide;
+}
+
+void DecorationToolTipScheduler::show(const QString &text)
+{
+    const qint64 now = m_clock();
+    m_text = text;
+    switch (m_state) {
+    case State::Hidden:
+        if (m_showDelay <= 0 || isWarm(now)) {
+            doShow(text);
+        } else {
+            schedule(State::PendingShow, now, m_showDelay);
+        }
+        break;
+    case State::PendingShow:
+        // keep the deadline, only the text changed
+        break;
+    case State::Visible:
+    case State::PendingHide:
+        m_state = State::Visible;
+        m_deadline = -1;
+        if (m_shownText != text) {
+            doShow(text);
+        }
+        break;
+    }
+}
+
+void DecorationToolTipScheduler::hide()
+{
+    switch (m_state) {
+    case State::Hidden:
+    case State::PendingHide:
+        break;
+    case State::PendingShow:
+        // never shown, so there is nothing to hide
+        m_state = State::Hidden;
+        m_deadline = -1;
+        break;
+    case State::Visible: {
+        const qint64 now = m_clock();
+        if (m_hideGracePeriod <= 0) {
+            doHide(now);
+        } else {
+            schedule(State::PendingHide, now, m_hideGracePeriod);
+        }
+        break;
+    }
+    }
+}
+
+void DecorationToolTipScheduler::reset()
+{
+    if (isVisible()) {
+        doHide(m_clock());
+    }
+    m_state = State::Hidden;
+    m_deadline = -1;
+    m_lastHidden = -1;
+}
+
+void DecorationToolTipScheduler::advance()
+{
+    if (m_deadline < 0) {
+        return;
+    }
+    const qint64 now = m_clock();
+    if (now < m_deadline) {
+        // woken up too early
+        if (m_wakeUpCallback) {
+            m_wakeUpCallback(int(m_deadline - now));
+        }
+        return;
+    }
+    if (m_state == State::PendingShow) {
+        doShow(m_text);
+    } else if (m_state == State::PendingHide) {
+        doHide(now);
+    }
+}
+
+void DecorationToolTipScheduler::doShow(const QString &text)
+{
+    m_state = State::Visible;
+    m_deadline = -1;
+    m_shownText = text;
+    if (m_showCallback) {
+        m_showCallback(text);
+    }
+}
+
+void DecorationToolTipScheduler::doHide(qint64 now)
+{
+    m_state = State::Hidden;
+    m_deadline = -1;
+    m_lastHidden = now;
+    m_shownText.clear();
+    if (m_hideCallback) {
+        m_hideCallback();
+    }
+}
+
+void DecorationToolTipScheduler::schedule(State state, qint64 now, int delay)
+{
+    m_state = state;
+    m_deadline = now + delay;
+    if (m_wakeUpCallback) {
+        m_wakeUpCallback(delay);
+    }
+}
+
+bool DecorationToolTipScheduler::isWarm(qint64 now) const
+{
+    return m_lastHidden >= 0 && now - m_lastHidden < m_warmPeriod;
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATIONTOOLTIPSCHEDULER_P_H
+#define KDECORATION2_DECORATIONTOOLTIPSCHEDULER_P_H
+
+#include <QString>
+
+#include <functional>
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+namespace KDecoration2
+{
+/**
+ * @brief Coalesces tooltip requests before they reach the DecoratedClient.
+ *
+ * Moving the pointer across a row of buttons causes a hide and a show for
+ * each button. The scheduler turns these into:
+ * @li a show after showDelay, unless the tooltip was hidden less than
+ *     warmPeriod ago, in which case it is shown right away
+ * @li a hide after hideGracePeriod, which is dropped if a show arrives in
+ *     the meantime; if the text changed only the text gets updated
+ *
+ * The scheduler does not own a timer. Whenever it needs to be woken up it
+ * passes the remaining time to the wakeUp callback and expects advance() to
+ * be called once it has passed. Time is read through the Clock, by default
+ * DecorationTimerService::now, so that it can be driven by a fake clock in tests.
+ *
+ * Both delays default to a few frames, setting them to @c 0 passes the
+ * requests through right away.
+ **/
+class Q_DECL_HIDDEN DecorationToolTipScheduler
+{
+public:
+    /**
+     * Returns a monotonic time in milliseconds.
+     **/
+    using Clock = std::function<qint64()>;
+
+    explicit DecorationToolTipScheduler(const Clock &clock = Clock());
+
+    void setShowCallback(const std::function<void(const QString &)> &callback);
+    void setHideCallback(const std::function<void()> &callback);
+    /**
+     * Called with the number of milliseconds after which advance() needs to be called.
+     **/
+    void setWakeUpCallback(const std::function<void(int)> &callback);
+
+    void setShowDelay(int msec);
+    int showDelay() const;
+    void setHideGracePeriod(int msec);
+    int hideGracePeriod() const;
+    void setWarmPeriod(int msec);
+    int warmPeriod() const;
+
+    void show(const QString &text);
+    void hide();
+    /**
+     * Hides a visible tooltip immediately and cancels anything pending.
+     **/
+    void reset();
+    /**
+     * Performs the pending show or hide if its deadline has been reached.
+     **/
+    void advance();
+
+    bool isVisible() const;
+    QString text() const;
+    /**
+     * @returns the deadline of the pending show or hide, @c -1 if nothing is pending.
+     **/
+    qint64 deadline() const;
+
+private:
+    enum class State {
+        Hidden,
+        PendingShow,
+        Visible,
+        PendingHide,
+    };
+    void doShow(const QString &text);
+    void doHide(qint64 now);
+    void schedule(State state, qint64 now, int delay);
+    bool isWarm(qint64 now) const;
+
+    Clock m_clock;
+    std::function<void(const QString &)> m_showCallback;
+    std::function<void()> m_hideCallback;
+    std::function<void(int)> m_wakeUpCallback;
+    State m_state = State::Hidden;
+    QString m_text;
+    QString m_shownText;
+    qint64 m_deadline = -1;
+    qint64 m_lastHidden = -1;
+    int m_showDelay = 50;
+    int m_hideGracePeriod = 50;
+    int m_warmPeriod = 500;
+};
+
+}
+
+#endif
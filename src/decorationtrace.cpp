@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#include "decorationtrace.h"
+#include "decorationtrace_p.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+
+namespace KDecoration2
+{
+#ifdef KDECORATION2_TRACING
+namespace
+{
+struct TraceEvent {
+    const char *name;
+    qint64 start;
+    qint64 duration;
+    quint32 thread;
+};
+
+// a power of two, so that the slot is a mask of the index
+const quint64 s_capacity = 65536;
+
+struct TraceBuffer {
+    std::atomic<quint64> next{0};
+    TraceEvent events[s_capacity];
+};
+
+TraceBuffer s_buffer;
+std::atomic<quint32> s_threads{0};
+
+quint32 currentThread()
+{
+    thread_local const quint32 thread = ++s_threads;
+    return thread;
+}
+}
+
+void TraceScope::record(const char *name, qint64 start, qint64 duration)
+{
+    // a slot is only reused after the ring buffer wrapped around
+    const quint64 index = s_buffer.next.fetch_add(1, std::memory_order_relaxed);
+    s_buffer.events[index & (s_capacity - 1)] = {name, start, duration, currentThread()};
+}
+#endif
+
+bool DecorationTrace::isEnabled()
+{
+#ifdef KDECORATION2_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+int DecorationTrace::eventCount()
+{
+#ifdef KDECORATION2_TRACING
+    return int(qMin(s_buffer.next.load(std::memory_order_relaxed), s_capacity));
+#else
+    return 0;
+#endif
+}
+
+void DecorationTrace::clear()
+{
+#ifdef KDECORATION2_TRACING
+    s_buffer.next.store(0, std::memory_order_relaxed);
+#endif
+}
+
+QByteArray DecorationTrace::toChromeTrace()
+{
+    QJsonArray events;
+#ifdef KDECORATION2_TRACING
+    const quint64 next = s_buffer.next.load(std::memory_order_acquire);
+    const quint64 first = next > s_capacity ? next - s_capacity : 0;
+    const qint64 pid = QCoreApplication::applicationPid();
+    for (quint64 i = first; i < next; ++i) {
+        const TraceEvent event = s_buffer.events[i & (s_capacity - 1)];
+        if (!event.name) {
+            // not written yet
+            continue;
+        }
+        // complete events, timestamps in microseconds
+        events.append(QJsonObject({
+            {QStringLiteral("name"), QString::fromLatin1(event.name)},
+            {QStringLiteral("cat"), QStringLiteral("kdecoration")},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), event.start / 1000.0},
+            {QStringLiteral("dur"), event.duration / 1000.0},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), qint64(event.thread)},
+        }));
+    }
+#endif
+    return QJsonDocument(QJsonObject({
+                             {QStringLiteral("traceEvents"), events},
+                             {QStringLiteral("displayTimeUnit"), QStringLiteral("ns")},
+                         }))
+        .toJson(QJsonDocument::Compact);
+}
+
+}
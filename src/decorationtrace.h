@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_TRACE_H
+#define KDECORATION2_DECORATION_TRACE_H
+
+#include <kdecoration2/kdecoration2_export.h>
+
+#include <QByteArray>
+
+namespace KDecoration2
+{
+/**
+ * @brief Access to the trace of the library's hot paths.
+ *
+ * If KDecoration is built with the KDECORATION2_TRACING option, the dispatching of input
+ * events, the hit testing, the layout of DecorationButtonGroups, the updates of Decorations
+ * and the calls into the DecorationBridge are timed. The most recent 65536 of these scopes
+ * are kept in a ring buffer, which can be exported in the Chrome trace event format and
+ * loaded into Perfetto or chrome://tracing next to a trace of the compositor.
+ *
+ * The timestamps are taken from the monotonic clock, like the ones of KWin. Without the
+ * build option the trace stays empty and the scopes are not compiled in.
+ *
+ * @since 5.22
+ **/
+class KDECORATIONS2_EXPORT DecorationTrace
+{
+public:
+    /**
+     * @returns Whether KDecoration got built with tracing.
+     **/
+    static bool isEnabled();
+    /**
+     * The number of scopes held by the ring buffer.
+     **/
+    static int eventCount();
+    /**
+     * Drops all recorded scopes.
+     **/
+    static void clear();
+    /**
+     * The recorded scopes as a JSON object in the Chrome trace event format, oldest first.
+     * Scopes which complete while the trace gets exported might be missing.
+     **/
+    static QByteArray toChromeTrace();
+
+private:
+    DecorationTrace() = delete;
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+ */
+#ifndef KDECORATION2_DECORATION_TRACE_P_H
+#define KDECORATION2_DECORATION_TRACE_P_H
+
+#include <QtGlobal>
+
+#ifdef KDECORATION2_TRACING
+#include <chrono>
+#endif
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KDecoration2 API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#ifdef KDECORATION2_TRACING
+
+namespace KDecoration2
+{
+/**
+ * Times the enclosing scope into the ring buffer of DecorationTrace.
+ * The @p name needs to be a string literal.
+ **/
+class Q_DECL_HIDDEN TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(name)
+        , m_start(now())
+    {
+    }
+    ~TraceScope()
+    {
+        record(m_name, m_start, now() - m_start);
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    static qint64 now()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static void record(const char *name, qint64 start, qint64 duration);
+
+    const char *m_name;
+    const qint64 m_start;
+};
+}
+
+#define KDECORATION2_TRACE_CONCAT_IMPL(a, b) a##b
+#define KDECORATION2_TRACE_CONCAT(a, b) KDECORATION2_TRACE_CONCAT_IMPL(a, b)
+#define KDECORATION2_TRACE_SCOPE(name) const KDecoration2::TraceScope KDECORATION2_TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#else
+
+#define KDECORATION2_TRACE_SCOPE(name) do { } while (false)
+
+#endif
+
+#endif
@@ -6,6 +6,12 @@
 #include "decoratedclientprivate.h"
 
 #include <QColor>
+#include <QPixmap>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+#include <memory>
 
 namespace KDecoration2
 {
@@ -15,6 +21,23 @@ public:
     explicit Private(DecoratedClient *client, Decoration *decoration);
     DecoratedClient *client;
     Decoration *decoration;
+
+    static constexpr int s_colorGroups = int(ColorGroup::Warning) + 1;
+    static constexpr int s_colorRoles = int(ColorRole::Foreground) + 1;
+    std::unique_ptr<QColor[]> paletteColors;
+    std::unique_ptr<QColor[]> decorationColors;
+
+    struct IconPixmap {
+        QSize size;
+        qreal devicePixelRatio;
+        QIcon::Mode mode;
+        QIcon::State state;
+        QPixmap pixmap;
+    };
+    // a decoration uses very few different sizes
+    static constexpr int s_maxIconPixmaps = 8;
+    QVector<IconPixmap> iconPixmaps;
+    QScopedPointer<QTimer> iconPrerenderTimer;
 };
 
 DecoratedClientPrivate::Private::Private(DecoratedClient *client, Decoration *decoration)
@@ -53,6 +76,97 @@ QColor DecoratedClientPrivate::color(ColorGroup group, ColorRole role) const
     return QColor();
 }
 
+QColor DecoratedClientPrivate::cachedColor(QPalette::ColorGroup group, QPalette::ColorRole role) const
+{
+    if (group >= QPalette::NColorGroups || role >= QPalette::NColorRoles) {
+        // QPalette::Current and QPalette::All depend on the palette
+        return palette().color(group, role);
+    }
+    if (!d->paletteColors) {
+        const QPalette p = palette();
+        d->paletteColors.reset(new QColor[QPalette::NColorGroups * QPalette::NColorRoles]);
+        for (int g = 0; g < QPalette::NColorGroups; ++g) {
+            for (int r = 0; r < QPalette::NColorRoles; ++r) {
+                d->paletteColors[g * QPalette::NColorRoles + r] = p.color(QPalette::ColorGroup(g), QPalette::ColorRole(r));
+            }
+        }
+    }
+    return d->paletteColors[group * QPalette::NColorRoles + role];
+}
+
+QColor DecoratedClientPrivate::cachedColor(ColorGroup group, ColorRole role) const
+{
+    if (!d->decorationColors) {
+        d->decorationColors.reset(new QColor[Private::s_colorGroups * Private::s_colorRoles]);
+        for (int g = 0; g < Private::s_colorGroups; ++g) {
+            for (int r = 0; r < Private::s_colorRoles; ++r) {
+                d->decorationColors[g * Private::s_colorRoles + r] = color(ColorGroup(g), ColorRole(r));
+            }
+        }
+    }
+    return d->decorationColors[int(group) * Private::s_colorRoles + int(role)];
+}
+
+void DecoratedClientPrivate::invalidateColorCache()
+{
+    d->paletteColors.reset();
+    d->decorationColors.reset();
+}
+
+static QPixmap renderIconPixmap(const QIcon &icon, const QSize &size, qreal devicePixelRatio, QIcon::Mode mode, QIcon::State state)
+{
+    QPixmap pixmap = icon.pixmap(size * devicePixelRatio, mode, state);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    return pixmap;
+}
+
+QPixmap DecoratedClientPrivate::cachedIconPixmap(const QSize &size, qreal devicePixelRatio, QIcon::Mode mode, QIcon::State state) const
+{
+    auto &pixmaps = d->iconPixmaps;
+    auto it = std::find_if(pixmaps.begin(), pixmaps.end(), [&](const Private::IconPixmap &entry) {
+        return entry.size == size && qFuzzyCompare(entry.devicePixelRatio, devicePixelRatio) && entry.mode == mode && entry.state == state;
+    });
+    if (it != pixmaps.end()) {
+        if (it->pixmap.isNull()) {
+            // not yet rendered again after the icon changed
+            it->pixmap = renderIconPixmap(icon(), size, devicePixelRatio, mode, state);
+        }
+        return it->pixmap;
+    }
+    if (pixmaps.count() == Private::s_maxIconPixmaps) {
+        pixmaps.removeFirst();
+    }
+    const QPixmap pixmap = renderIconPixmap(icon(), size, devicePixelRatio, mode, state);
+    pixmaps.append({size, devicePixelRatio, mode, state, pixmap});
+    return pixmap;
+}
+
+void DecoratedClientPrivate::invalidateIconCache()
+{
+    if (d->iconPixmaps.isEmpty()) {
+        return;
+    }
+    for (auto &entry : d->iconPixmaps) {
+        entry.pixmap = QPixmap();
+    }
+    if (!d->iconPrerenderTimer) {
+        // QIcon and QPixmap can only be used on the GUI thread, so the pixmaps get
+        // rendered in the next event loop pass instead of in a worker thread
+        d->iconPrerenderTimer.reset(new QTimer);
+        d->iconPrerenderTimer->setSingleShot(true);
+        d->iconPrerenderTimer->setInterval(0);
+        QObject::connect(d->iconPrerenderTimer.data(), &QTimer::timeout, [this] {
+            const QIcon icon = this->icon();
+            for (auto &entry : d->iconPixmaps) {
+                if (entry.pixmap.isNull()) {
+                    entry.pixmap = renderIconPixmap(icon, entry.size, entry.devicePixelRatio, entry.mode, entry.state);
+                }
+            }
+        });
+    }
+    d->iconPrerenderTimer->start();
+}
+
 ApplicationMenuEnabledDecoratedClientPrivate::ApplicationMenuEnabledDecoratedClientPrivate(DecoratedClient *client, Decoration *decoration)
     : DecoratedClientPrivate(client, decoration)
 {
@@ -10,6 +10,7 @@
 #include <kdecoration2/private/kdecoration2_private_export.h>
 
 #include <QIcon>
+#include <QPalette>
 #include <QString>
 
 //
@@ -79,6 +80,36 @@ public:
 
     virtual QColor color(ColorGroup group, ColorRole role) const;
 
+    /**
+     * Looks up the color in a table built from palette() on first use.
+     * @since 5.22
+     **/
+    QColor cachedColor(QPalette::ColorGroup group, QPalette::ColorRole role) const;
+    /**
+     * Looks up the color in a table built from color() on first use.
+     * @since 5.22
+     **/
+    QColor cachedColor(ColorGroup group, ColorRole role) const;
+    /**
+     * Discards the tables used by cachedColor. This happens automatically
+     * whenever DecoratedClient::paletteChanged is emitted.
+     * @since 5.22
+     **/
+    void invalidateColorCache();
+
+    /**
+     * Looks up icon() rendered for the given parameters, rendering it on a miss.
+     * @since 5.22
+     **/
+    QPixmap cachedIconPixmap(const QSize &size, qreal devicePixelRatio, QIcon::Mode mode, QIcon::State state) const;
+    /**
+     * Discards the pixmaps used by cachedIconPixmap. The pixmaps which were in use get rendered
+     * again from the new icon once control returns to the event loop. This happens automatically
+     * whenever DecoratedClient::iconChanged is emitted.
+     * @since 5.22
+     **/
+    void invalidateIconCache();
+
 protected:
     explicit DecoratedClientPrivate(DecoratedClient *client, Decoration *decoration);
     DecoratedClient *client();
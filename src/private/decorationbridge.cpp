@@ -5,16 +5,80 @@
  */
 #include "decorationbridge.h"
 
+#include <QPointer>
+#include <QRect>
+#include <QVector>
+
 Q_DECLARE_METATYPE(Qt::MouseButton)
 
 namespace KDecoration2
 {
+class Q_DECL_HIDDEN DecorationBridge::Private
+{
+public:
+    QVector<QPointer<QObject>> recycled;
+    int recyclePoolSize = 8;
+};
+
 DecorationBridge::DecorationBridge(QObject *parent)
     : QObject(parent)
+    , d(new Private)
 {
     qRegisterMetaType<Qt::MouseButton>();
 }
 
-DecorationBridge::~DecorationBridge() = default;
+DecorationBridge::~DecorationBridge()
+{
+    clearRecycledDecorations();
+}
+
+void DecorationBridge::updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale)
+{
+    const QRectF geometry(QPointF(deviceGeometry.topLeft()) / scale, QSizeF(deviceGeometry.size()) / scale);
+    update(decoration, geometry.toAlignedRect());
+}
+
+int DecorationBridge::recyclePoolSize() const
+{
+    return d->recyclePoolSize;
+}
+
+void DecorationBridge::setRecyclePoolSize(int size)
+{
+    d->recyclePoolSize = qMax(0, size);
+    while (d->recycled.count() > d->recyclePoolSize) {
+        delete d->recycled.takeFirst().data();
+    }
+}
+
+void DecorationBridge::recycleDecoration(QObject *decoration)
+{
+    Q_ASSERT(decoration);
+    Q_ASSERT(!d->recycled.contains(decoration));
+    if (d->recycled.count() >= d->recyclePoolSize) {
+        delete decoration;
+        return;
+    }
+    decoration->setParent(nullptr);
+    d->recycled.append(QPointer<QObject>(decoration));
+}
+
+QObject *DecorationBridge::takeRecycledDecoration()
+{
+    while (!d->recycled.isEmpty()) {
+        // entries turn null if a Decoration got deleted while waiting in the pool
+        if (QObject *decoration = d->recycled.takeLast()) {
+            return decoration;
+        }
+    }
+    return nullptr;
+}
+
+void DecorationBridge::clearRecycledDecorations()
+{
+    while (!d->recycled.isEmpty()) {
+        delete d->recycled.takeLast().data();
+    }
+}
 
 }
@@ -41,10 +41,56 @@ public:
 
     virtual std::unique_ptr<DecoratedClientPrivate> createClient(DecoratedClient *client, Decoration *decoration) = 0;
     virtual void update(Decoration *decoration, const QRect &geometry) = 0;
+    /**
+     * Invoked instead of update for each of the Decoration's scales other than @c 1.
+     * The @p deviceGeometry is in physical pixels of the given @p scale, so that the
+     * buffer of each output only needs to be repainted where it got damaged.
+     *
+     * An implementation passes the scales of all outputs a window is shown on to
+     * Decoration::setScales and renders each of them with Decoration::render.
+     *
+     * The default implementation converts the @p deviceGeometry to logical
+     * coordinates and invokes update.
+     * @since 5.22
+     **/
+    virtual void updateScaled(Decoration *decoration, const QRect &deviceGeometry, qreal scale);
     virtual std::unique_ptr<DecorationSettingsPrivate> settings(DecorationSettings *parent) = 0;
 
+    /**
+     * The maximum number of recycled Decorations kept for reuse. Defaults to @c 8,
+     * a size of @c 0 disables recycling.
+     * @since 5.22
+     **/
+    int recyclePoolSize() const;
+    void setRecyclePoolSize(int size);
+    /**
+     * Invoked by Decoration::recycle to hand a no longer used @p decoration back to the bridge.
+     * If the pool is full the @p decoration gets deleted.
+     *
+     * The pool only knows the Decorations as QObjects, this library does not depend on the
+     * one providing Decoration.
+     * @since 5.22
+     **/
+    void recycleDecoration(QObject *decoration);
+    /**
+     * Takes a recycled Decoration out of the pool. The returned Decoration has no parent and
+     * needs to be bound to its new window with Decoration::rebind.
+     * @returns A recycled Decoration, to be cast with qobject_cast, or @c nullptr if the pool is empty
+     * @since 5.22
+     **/
+    QObject *takeRecycledDecoration();
+    /**
+     * Deletes all Decorations in the pool, e.g. before a different decoration plugin gets loaded.
+     * @since 5.22
+     **/
+    void clearRecycledDecorations();
+
 protected:
     explicit DecorationBridge(QObject *parent = nullptr);
+
+private:
+    class Private;
+    const QScopedPointer<Private> d;
 };
 
 } // namespace
@@ -16,6 +16,8 @@ public:
     int gridUnit = -1;
     int smallSpacing = -1;
     int largeSpacing = -1;
+    int updateDepth = 0;
+    std::function<void()> updateFinished;
 };
 
 DecorationSettingsPrivate::Private::Private(DecorationSettings *settings)
@@ -82,4 +84,27 @@ void DecorationSettingsPrivate::setSmallSpacing(int spacing)
     d->smallSpacing = spacing;
 }
 
+void DecorationSettingsPrivate::beginUpdate()
+{
+    d->updateDepth++;
+}
+
+void DecorationSettingsPrivate::endUpdate()
+{
+    Q_ASSERT(d->updateDepth > 0);
+    if (--d->updateDepth == 0 && d->updateFinished) {
+        d->updateFinished();
+    }
+}
+
+bool DecorationSettingsPrivate::isUpdating() const
+{
+    return d->updateDepth > 0;
+}
+
+void DecorationSettingsPrivate::setUpdateFinishedCallback(const std::function<void()> &callback)
+{
+    d->updateFinished = callback;
+}
+
 }
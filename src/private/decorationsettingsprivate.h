@@ -12,6 +12,8 @@
 #include <QVector>
 #include <kdecoration2/private/kdecoration2_private_export.h>
 
+#include <functional>
+
 //
 //  W A R N I N G
 //  -------------
@@ -50,6 +52,21 @@ public:
     void setLargeSpacing(int spacing);
     void setSmallSpacing(int spacing);
 
+    /**
+     * Starts a batch of setting changes. The signals of the individual settings are still
+     * emitted right away, DecorationSettings::changed is emitted once for all of them when
+     * the batch ends with the matching endUpdate. Batches can be nested.
+     * @since 5.22
+     **/
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const;
+    /**
+     * Used by DecorationSettings to get notified when the outermost batch ends.
+     * @since 5.22
+     **/
+    void setUpdateFinishedCallback(const std::function<void()> &callback);
+
 protected:
     explicit DecorationSettingsPrivate(DecorationSettings *parent);
 